@@ -0,0 +1,199 @@
+/**
+ * @file async_file.hh
+ * @brief 分块异步文件读写
+ * 
+ * 文件按固定大小的块读写，同时保持多个块的I/O在途：读取时调用方解析当前块，
+ * 后面几块已经在读；写出时调用方继续格式化，前面写满的块在后台落盘。
+ * Linux上通过io_uring提交请求（不依赖liburing，直接使用系统调用）；
+ * 内核不支持或编译时定义SMS_NO_IO_URING时退化为同步pread/pwrite。
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class IoQueue;
+
+/**
+ * @class FileReader
+ * @brief 顺序分块读取文件，预读后续块
+ * 
+ * next返回的块在下一次调用next或read_line前有效。
+ */
+class FileReader {
+public:
+    static constexpr size_t CHUNK_SIZE = 1 << 20;         ///< 块大小（直接I/O对齐的整数倍）
+    static constexpr size_t QUEUE_DEPTH = 4;              ///< 同时在途的块数
+    static constexpr uint64_t DIRECT_MIN_SIZE = 64 << 20; ///< 前面这部分不使用直接I/O
+    
+    FileReader();
+    
+    /**
+     * @brief 析构函数，等待在途请求完成后关闭文件
+     */
+    ~FileReader();
+    
+    FileReader(const FileReader&) = delete;
+    FileReader& operator=(const FileReader&) = delete;
+    
+    /**
+     * @brief 打开文件并提交前几块的读请求
+     * @param filename 文件名
+     * @param direct 是否尝试绕过页缓存（O_DIRECT），读取位置达到DIRECT_MIN_SIZE后才生效，
+     *               文件系统不支持时保持普通读取
+     * @return bool 文件打开成功返回true
+     */
+    bool open(const std::string& filename, bool direct = false);
+    
+    /**
+     * @brief 取下一块数据
+     * @param data 输出参数，块数据
+     * @param size 输出参数，块长度（除最后一块外都是CHUNK_SIZE）
+     * @return bool 读到数据返回true，文件结束或读取失败返回false（用failed区分）
+     */
+    bool next(const char*& data, size_t& size);
+    
+    /**
+     * @brief 读取一行（不含换行符），可跨块
+     * @param line 输出参数，行内容
+     * @return bool 读到一行返回true，文件结束或读取失败返回false
+     */
+    bool read_line(std::string& line);
+    
+    /**
+     * @brief 等待在途请求完成并关闭文件
+     */
+    void close();
+    
+    bool is_open() const { return fd_ >= 0; }  ///< 是否已打开
+    bool failed() const { return failed_; }    ///< 是否发生读取错误
+    uint64_t size() const { return size_; }    ///< 文件长度
+    bool uses_io_uring() const;                ///< 是否通过io_uring读取
+
+private:
+    /**
+     * @struct Slot
+     * @brief 一个块缓冲区及其在途请求
+     */
+    struct Slot {
+        char* data = nullptr;   ///< 缓冲区（按直接I/O要求对齐）
+        uint64_t offset = 0;    ///< 块在文件中的偏移
+        long result = 0;        ///< 读取结果（字节数或负的错误码）
+        bool pending = false;   ///< 请求是否在途
+        bool ready = false;     ///< 请求已完成、尚未交给调用方
+    };
+    
+    int fd_ = -1;                      ///< 文件描述符
+    bool want_direct_ = false;         ///< 读取位置达到DIRECT_MIN_SIZE后是否改用直接I/O
+    bool direct_ = false;              ///< 是否正在使用直接I/O
+    bool failed_ = false;              ///< 是否发生读取错误
+    uint64_t size_ = 0;                ///< 文件长度
+    uint64_t next_offset_ = 0;         ///< 下一个要提交的块偏移
+    size_t current_ = 0;               ///< 下一个交给调用方的块所在槽位
+    bool holding_ = false;             ///< 调用方是否持有current_之前的槽位
+    std::vector<Slot> slots_;          ///< 块缓冲区（环形使用）
+    std::unique_ptr<IoQueue> queue_;   ///< 请求队列
+    const char* line_data_ = nullptr;  ///< read_line当前块中未消费的部分
+    size_t line_size_ = 0;             ///< 未消费部分的长度
+    
+    /**
+     * @brief 为槽位提交下一块的读请求（文件已读完时不提交）
+     * @param slot 槽位下标
+     */
+    void submit(size_t slot);
+    
+    /**
+     * @brief 等待槽位的请求完成
+     * @param slot 槽位下标
+     */
+    void wait(size_t slot);
+};
+
+/**
+ * @class FileWriter
+ * @brief 顺序分块写出文件，写满的块在后台落盘
+ * 
+ * 写出的数据先复制进块缓冲区，缓冲区写满即提交；全部缓冲区都在途时等待最早的一块完成。
+ * 必须调用close并检查返回值，才能确认数据已全部写出。
+ */
+class FileWriter {
+public:
+    static constexpr size_t CHUNK_SIZE = FileReader::CHUNK_SIZE;    ///< 块大小
+    static constexpr size_t QUEUE_DEPTH = FileReader::QUEUE_DEPTH;  ///< 同时在途的块数
+    static constexpr uint64_t DIRECT_MIN_SIZE = FileReader::DIRECT_MIN_SIZE;  ///< 前面这部分不使用直接I/O
+    
+    FileWriter();
+    
+    /**
+     * @brief 析构函数，未调用close时仍会写出剩余数据
+     */
+    ~FileWriter();
+    
+    FileWriter(const FileWriter&) = delete;
+    FileWriter& operator=(const FileWriter&) = delete;
+    
+    /**
+     * @brief 创建或截断文件
+     * @param filename 文件名
+     * @param direct 是否尝试绕过页缓存（O_DIRECT），写出量达到DIRECT_MIN_SIZE后才生效，
+     *               文件系统不支持时保持普通写出
+     * @return bool 文件打开成功返回true
+     */
+    bool open(const std::string& filename, bool direct = false);
+    
+    /**
+     * @brief 追加数据
+     * @param data 数据
+     * @param size 长度
+     */
+    void write(const char* data, size_t size);
+    
+    void write(const std::string& text) { write(text.data(), text.size()); }  ///< 追加字符串
+    
+    /**
+     * @brief 写出剩余数据、等待全部请求完成并关闭文件
+     * @return bool 全部数据写出成功返回true
+     */
+    bool close();
+    
+    bool is_open() const { return fd_ >= 0; }  ///< 是否已打开
+    bool failed() const { return failed_; }    ///< 是否发生写出错误
+    bool uses_io_uring() const;                ///< 是否通过io_uring写出
+
+private:
+    /**
+     * @struct Slot
+     * @brief 一个块缓冲区及其在途请求
+     */
+    struct Slot {
+        char* data = nullptr;   ///< 缓冲区（按直接I/O要求对齐）
+        size_t length = 0;      ///< 已填充的长度
+        size_t request = 0;     ///< 提交的请求长度（直接I/O时补齐到对齐长度）
+        uint64_t offset = 0;    ///< 块在文件中的偏移
+        bool pending = false;   ///< 请求是否在途
+    };
+    
+    int fd_ = -1;                     ///< 文件描述符
+    bool want_direct_ = false;        ///< 写出量达到DIRECT_MIN_SIZE后是否改用直接I/O
+    bool direct_ = false;             ///< 是否正在使用直接I/O
+    bool failed_ = false;             ///< 是否发生写出错误
+    uint64_t written_ = 0;            ///< 已提交的数据长度（不含对齐填充）
+    size_t current_ = 0;              ///< 正在填充的槽位
+    std::vector<Slot> slots_;         ///< 块缓冲区（环形使用）
+    std::unique_ptr<IoQueue> queue_;  ///< 请求队列
+    
+    /**
+     * @brief 提交当前槽位并切换到下一个槽位
+     */
+    void submit_current();
+    
+    /**
+     * @brief 等待槽位的请求完成并检查结果
+     * @param slot 槽位下标
+     */
+    void wait(size_t slot);
+};
@@ -0,0 +1,134 @@
+/**
+ * @file binary_io.hh
+ * @brief 索引序列化用的二进制读写工具
+ * 
+ * 以本机字节序写入定长整数、变长字符串和平凡类型数组，读取时逐项检查越界。
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief 追加一个平凡类型的值
+ * @tparam T 平凡可复制类型
+ * @param out 输出缓冲区
+ * @param value 值
+ */
+template<typename T>
+void write_pod(std::string& out, const T& value) {
+    static_assert(std::is_trivially_copyable<T>::value, "write_pod需要平凡可复制类型");
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/**
+ * @brief 追加带32位长度前缀的字符串
+ * @param out 输出缓冲区
+ * @param text 字符串
+ */
+inline void write_string(std::string& out, const std::string& text) {
+    write_pod(out, static_cast<uint32_t>(text.size()));
+    out += text;
+}
+
+/**
+ * @brief 追加带64位元素数前缀的平凡类型数组
+ * @tparam T 平凡可复制类型
+ * @param out 输出缓冲区
+ * @param values 数组
+ */
+template<typename T>
+void write_array(std::string& out, const std::vector<T>& values) {
+    static_assert(std::is_trivially_copyable<T>::value, "write_array需要平凡可复制类型");
+    write_pod(out, static_cast<uint64_t>(values.size()));
+    out.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+}
+
+/**
+ * @class BinaryReader
+ * @brief 顺序读取write_pod/write_string/write_array写入的数据
+ * 
+ * 任何一次读取越界后reader进入失败状态，之后的读取都返回false。
+ */
+class BinaryReader {
+public:
+    /**
+     * @brief 构造函数
+     * @param data 数据起始地址
+     * @param size 数据长度
+     */
+    BinaryReader(const char* data, size_t size) : data_(data), size_(size) {}
+    
+    /**
+     * @brief 读取一个平凡类型的值
+     * @tparam T 平凡可复制类型
+     * @param value 输出参数
+     * @return bool 读取成功返回true
+     */
+    template<typename T>
+    bool read(T& value) {
+        if (!take(sizeof(T))) return false;
+        std::memcpy(&value, data_ + offset_ - sizeof(T), sizeof(T));
+        return true;
+    }
+    
+    /**
+     * @brief 读取带长度前缀的字符串
+     * @param text 输出参数
+     * @return bool 读取成功返回true
+     */
+    bool read_string(std::string& text) {
+        uint32_t length = 0;
+        if (!read(length) || !take(length)) return false;
+        text.assign(data_ + offset_ - length, length);
+        return true;
+    }
+    
+    /**
+     * @brief 读取带元素数前缀的平凡类型数组
+     * @tparam T 平凡可复制类型
+     * @param values 输出参数
+     * @return bool 读取成功返回true
+     */
+    template<typename T>
+    bool read_array(std::vector<T>& values) {
+        uint64_t count = 0;
+        if (!read(count) || count > (size_ - offset_) / sizeof(T)) {
+            failed_ = true;
+            return false;
+        }
+        values.resize(static_cast<size_t>(count));
+        std::memcpy(values.data(), data_ + offset_, values.size() * sizeof(T));
+        offset_ += values.size() * sizeof(T);
+        return true;
+    }
+    
+    bool ok() const { return !failed_; }                    ///< 是否未发生越界
+    bool at_end() const { return !failed_ && offset_ == size_; } ///< 是否恰好读完全部数据
+    size_t offset() const { return offset_; }               ///< 当前读取位置
+
+private:
+    const char* data_;     ///< 数据起始地址
+    size_t size_;          ///< 数据长度
+    size_t offset_ = 0;    ///< 当前读取位置
+    bool failed_ = false;  ///< 是否发生过越界
+    
+    /**
+     * @brief 消耗指定字节数
+     * @param length 字节数
+     * @return bool 剩余数据足够返回true
+     */
+    bool take(size_t length) {
+        if (failed_ || length > size_ - offset_) {
+            failed_ = true;
+            return false;
+        }
+        offset_ += length;
+        return true;
+    }
+};
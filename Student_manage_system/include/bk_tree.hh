@@ -0,0 +1,125 @@
+/**
+ * @file bk_tree.hh
+ * @brief BK树（编辑距离近似查询）
+ * 
+ * 以Unicode码点为单位计算Levenshtein编辑距离，利用三角不等式剪枝，
+ * 用于姓名、拼音的容错查询。
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 将UTF-8字符串解码为Unicode码点序列
+ * @param text UTF-8字符串
+ * @return std::u32string 码点序列（非法字节按单字节原样保留）
+ */
+std::u32string utf8_to_codepoints(const std::string& text);
+
+/**
+ * @brief 计算两个码点序列的Levenshtein编辑距离
+ * @param a 第一个序列
+ * @param b 第二个序列
+ * @return int 编辑距离
+ */
+int edit_distance(const std::u32string& a, const std::u32string& b);
+
+/**
+ * @class BKTree
+ * @brief 支持重复键和删除的BK树
+ * 
+ * 删除只减少键的计数，计数为0的节点仍参与剪枝但不出现在结果中；
+ * 这样的节点超过一半时用剩余的键重建整棵树，重建的开销均摊到每次删除上是常数次插入。
+ */
+class BKTree {
+public:
+    /**
+     * @brief 插入键（允许重复）
+     * @param key UTF-8键
+     */
+    void insert(const std::string& key);
+    
+    /**
+     * @brief 删除键的一次出现
+     * @param key UTF-8键
+     * @return bool 键存在并被删除返回true
+     */
+    bool erase(const std::string& key);
+    
+    /**
+     * @brief 查找编辑距离不超过max_distance的键
+     * @param query UTF-8查询串
+     * @param max_distance 最大编辑距离
+     * @param max_visits 最多访问的节点数，用于限制单次查询耗时
+     * @return std::vector<std::pair<std::string, int>> (键, 距离)列表，按距离升序
+     */
+    std::vector<std::pair<std::string, int>> search(const std::string& query, int max_distance,
+                                                    size_t max_visits = SIZE_MAX) const;
+    
+    /**
+     * @brief 清空
+     */
+    void clear() {
+        nodes_.clear();
+        dead_nodes_ = 0;
+    }
+    
+    /**
+     * @brief 获取节点数（含已删除键、尚未重建掉的节点）
+     * @return size_t 节点数
+     */
+    size_t node_count() const { return nodes_.size(); }
+    
+    /**
+     * @brief 将树追加到缓冲区（码点序列不保存，恢复时由键重新计算）
+     * @param out 输出缓冲区
+     */
+    void serialize(std::string& out) const;
+    
+    /**
+     * @brief 从serialize的输出恢复树，省去插入时的编辑距离计算
+     * @param data 数据起始地址
+     * @param size 数据长度
+     * @return bool 数据完整且子节点下标合法返回true，失败时树保持不变
+     */
+    bool deserialize(const char* data, size_t size);
+
+private:
+    /**
+     * @struct Node
+     * @brief BK树节点
+     */
+    struct Node {
+        std::string key;                ///< UTF-8键
+        std::u32string codepoints;      ///< 键的码点序列
+        uint32_t count = 0;             ///< 键出现次数
+        std::vector<std::pair<int, uint32_t>> children; ///< (与本节点的距离, 子节点下标)
+    };
+    
+    std::vector<Node> nodes_;  ///< 节点数组，下标0为根
+    size_t dead_nodes_ = 0;    ///< 计数为0的节点数
+    
+    /**
+     * @brief 查找与键完全相同的节点
+     * @param codepoints 键的码点序列
+     * @return long 节点下标，不存在返回-1
+     */
+    long find(const std::u32string& codepoints) const;
+    
+    /**
+     * @brief 插入键的count次出现
+     * @param key UTF-8键
+     * @param codepoints 键的码点序列
+     * @param count 出现次数
+     */
+    void insert(std::string key, std::u32string codepoints, uint32_t count);
+    
+    /**
+     * @brief 丢弃计数为0的节点，按原数组顺序重新插入其余的键
+     */
+    void rebuild();
+};
@@ -0,0 +1,104 @@
+/**
+ * @file block_checksum.hh
+ * @brief 数据文件的分块校验文件
+ * 
+ * 保存数据文件时按BLOCK_SIZE分块计算CRC32C，写入旁边的校验文件（数据文件名加".crc"）；
+ * 加载前按块并行校验，能指出损坏位于哪些块。校验文件同时记录数据文件的长度和修改时间，
+ * 两者与数据文件不一致说明数据文件在保存后被其他程序编辑过，此时校验文件视为过期。
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @class BlockChecksums
+ * @brief 数据文件各块的CRC32C
+ * 
+ * 文件采用本机字节序，自身末尾带有整个校验文件的CRC32C，损坏的校验文件按不存在处理。
+ */
+class BlockChecksums {
+public:
+    static constexpr size_t BLOCK_SIZE = 1 << 20;  ///< 块大小（最后一块可以不满）
+    
+    /**
+     * @brief 获取数据文件对应的校验文件名
+     * @param data_filename 数据文件名
+     * @return std::string 校验文件名
+     */
+    static std::string path_for(const std::string& data_filename) { return data_filename + ".crc"; }
+    
+    /**
+     * @brief 顺序读取整个文件计算CRC32C
+     * @param filename 文件名
+     * @param crc 输出参数，CRC32C
+     * @param size 输出参数，文件长度
+     * @return bool 文件可读返回true
+     */
+    static bool checksum_file(const std::string& filename, uint32_t& crc, uint64_t& size);
+    
+    /**
+     * @brief 追加数据文件的内容（保存时边写边算）
+     * @param data 数据
+     * @param size 长度
+     */
+    void update(const char* data, size_t size);
+    
+    /**
+     * @brief 写出校验文件（先写临时文件再改名），在数据文件关闭之后调用
+     * @param filename 校验文件名
+     * @param data_filename 数据文件名，用于记录其修改时间
+     * @return bool 写入成功返回true
+     */
+    bool write(const std::string& filename, const std::string& data_filename) const;
+    
+    /**
+     * @brief 读取校验文件
+     * @param filename 校验文件名
+     * @return bool 文件存在且完整返回true
+     */
+    bool read(const std::string& filename);
+    
+    /**
+     * @brief 数据文件的长度和修改时间是否与保存时一致
+     * @param data_filename 数据文件名
+     * @return bool 一致返回true，此时校验结果可信
+     */
+    bool matches(const std::string& data_filename) const;
+    
+    /**
+     * @brief 按块并行校验数据文件
+     * @param data_filename 数据文件名
+     * @param bad_blocks 输出参数，校验失败的块号（升序）
+     * @param threads 线程数，0表示按硬件并发数，1表示在调用线程中进行
+     * @return bool 全部块校验通过返回true，文件无法读取时所有块都视为失败
+     */
+    bool verify(const std::string& data_filename, std::vector<uint64_t>& bad_blocks, size_t threads = 0) const;
+    
+    uint64_t data_size() const { return data_size_; }                   ///< 数据文件长度
+    size_t block_count() const { return block_count_of(data_size_); }  ///< 块数
+
+private:
+    uint64_t data_size_ = 0;         ///< 数据文件长度
+    int64_t data_mtime_ = 0;         ///< 数据文件修改时间（文件时钟的计数值）
+    std::vector<uint32_t> blocks_;   ///< 已写满的块的CRC32C
+    uint32_t current_ = 0;           ///< 正在填充的块的CRC32C
+    
+    /**
+     * @brief 计算数据长度对应的块数
+     * @param size 数据长度
+     * @return size_t 块数
+     */
+    static size_t block_count_of(uint64_t size) { return static_cast<size_t>((size + BLOCK_SIZE - 1) / BLOCK_SIZE); }
+    
+    /**
+     * @brief 读取数据文件的修改时间
+     * @param data_filename 数据文件名
+     * @param mtime 输出参数，修改时间
+     * @return bool 读取成功返回true
+     */
+    static bool modification_time(const std::string& data_filename, int64_t& mtime);
+};
@@ -0,0 +1,112 @@
+/**
+ * @file bloom_filter.hh
+ * @brief 分块布隆过滤器
+ * 
+ * 每个键的全部比特位落在同一个64字节块内，一次查询只访问一条缓存行，
+ * 用于在查哈希表之前快速排除不存在的学号。键由调用方预先哈希为64位整数。
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @struct BloomFilterStats
+ * @brief 布隆过滤器命中统计
+ */
+struct BloomFilterStats {
+    uint64_t queries = 0;          ///< 查询次数
+    uint64_t negatives = 0;        ///< 过滤器直接判定不存在的次数
+    uint64_t false_positives = 0;  ///< 过滤器判定可能存在但实际不存在的次数
+    
+    /**
+     * @brief 计算假阳性率
+     * @return double 假阳性次数 / 实际不存在的查询次数，无此类查询时为0
+     */
+    double false_positive_rate() const {
+        uint64_t misses = negatives + false_positives;
+        return misses == 0 ? 0.0 : static_cast<double>(false_positives) / misses;
+    }
+};
+
+/**
+ * @class BloomFilter
+ * @brief 分块布隆过滤器（不支持删除）
+ * 
+ * 删除的键仍留在过滤器中，只会提高假阳性率，不会产生假阴性。
+ * 插入数（含已删除的键）超过容量后由调用方按当前键集合重建。
+ * may_contain可在多个读线程中并发调用。
+ */
+class BloomFilter {
+public:
+    /**
+     * @brief 构造函数
+     * @param capacity 预期键数量
+     * @param bits_per_key 每个键占用的比特数（10约对应1%的假阳性率）
+     */
+    explicit BloomFilter(size_t capacity = 1024, size_t bits_per_key = 10);
+    
+    /**
+     * @brief 插入键
+     * @param hash 键的64位哈希值（须充分混合，如StudentIdHash）
+     */
+    void insert(uint64_t hash);
+    
+    /**
+     * @brief 判断键是否可能存在（统计查询次数）
+     * @param hash 键的64位哈希值
+     * @return bool 返回false时键一定不存在
+     */
+    bool may_contain(uint64_t hash) const;
+    
+    /**
+     * @brief 记录一次假阳性（may_contain返回true但键实际不存在）
+     */
+    void record_false_positive() const;
+    
+    /**
+     * @brief 按新容量清空过滤器（保留统计数据）
+     * @param capacity 预期键数量
+     */
+    void reset(size_t capacity);
+    
+    /**
+     * @brief 获取统计数据
+     * @return BloomFilterStats 统计快照
+     */
+    BloomFilterStats stats() const;
+    
+    /**
+     * @brief 将容量、插入数和比特数组追加到缓冲区（不含统计数据）
+     * @param out 输出缓冲区
+     */
+    void serialize(std::string& out) const;
+    
+    /**
+     * @brief 从serialize的输出恢复过滤器（保留统计数据）
+     * @param data 数据起始地址
+     * @param size 数据长度
+     * @return bool 数据完整且比特数组长度与容量一致返回true，失败时过滤器保持不变
+     */
+    bool deserialize(const char* data, size_t size);
+    
+    size_t size() const { return size_; }          ///< 已插入的键数（含已删除的键）
+    size_t capacity() const { return capacity_; }  ///< 容量
+
+private:
+    static constexpr size_t BLOCK_WORDS = 8;   ///< 每块64位字数（512比特，一条缓存行）
+    static constexpr int HASH_COUNT = 6;       ///< 每个键设置的比特数
+    
+    std::vector<uint64_t> bits_;   ///< 比特数组，按块连续存放
+    size_t block_count_ = 1;       ///< 块数
+    size_t bits_per_key_;          ///< 每个键占用的比特数
+    size_t capacity_ = 0;          ///< 容量
+    size_t size_ = 0;              ///< 已插入的键数
+    mutable std::atomic<uint64_t> queries_{0};          ///< 查询次数
+    mutable std::atomic<uint64_t> negatives_{0};        ///< 判定不存在的次数
+    mutable std::atomic<uint64_t> false_positives_{0};  ///< 假阳性次数
+};
@@ -0,0 +1,228 @@
+/**
+ * @file change_stream.hh
+ * @brief 学生数据变更流（CDC）
+ * 
+ * 为每次数据修改生成带序列号的变更事件，按顺序分发给订阅回调、
+ * 环形缓冲区中的进程内消费者，以及可选的追加式日志文件，
+ * 使下游镜像可以增量同步而不必重新读取整个students.csv。
+ * 没有任何消费者时不构造事件，只占用序列号。
+ */
+
+#pragma once
+
+#include "student.hh"
+#include "ring_buffer.hh"
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @enum ChangeType
+ * @brief 变更事件类型
+ */
+enum class ChangeType {
+    ADD = 0,        ///< 新增学生，携带完整记录
+    UPDATE = 1,     ///< 修改学生，student_id为原学号，携带修改后的完整记录
+    DELETE = 2,     ///< 删除学生
+    SCORE_SET = 3,  ///< 设置单科成绩
+    CLEAR = 4,      ///< 清空全部学生（整体重新加载前发出）
+    SNAPSHOT = 5    ///< 整体加载完成，不携带学生数据（见ChangeStream::publish_snapshot）
+};
+
+/**
+ * @struct ChangeEvent
+ * @brief 单条变更事件
+ */
+struct ChangeEvent {
+    uint64_t sequence = 0;        ///< 序列号，从1开始严格递增
+    int64_t timestamp_ms = 0;     ///< 事件产生时间（Unix毫秒）
+    ChangeType type = ChangeType::ADD; ///< 事件类型
+    std::string student_id;       ///< 目标学号
+    Student student;              ///< ADD/UPDATE时的完整学生记录
+    std::string subject;          ///< SCORE_SET时的科目
+    float score = 0.0f;           ///< SCORE_SET时的成绩
+};
+
+/**
+ * @class ChangeStream
+ * @brief 变更事件发布器
+ * 
+ * 线程安全：发布与读取可以在不同线程进行。订阅回调在发布线程中同步调用，
+ * 此时StudentManagementSystem持有写锁，回调内不应再调用其接口。
+ * 打开日志文件、有订阅回调、或调用过read_since/last_sequence（轮询环形缓冲区）都算有消费者。
+ */
+class ChangeStream {
+public:
+    using Callback = std::function<void(const ChangeEvent&)>; ///< 订阅回调类型
+    
+    /**
+     * @brief 构造函数
+     * @param ring_capacity 环形缓冲区容量（保留的最近事件数）
+     */
+    explicit ChangeStream(size_t ring_capacity = 4096);
+    
+    /**
+     * @brief 注册订阅回调
+     * @param callback 每个事件发布后调用的回调
+     * @return int 订阅编号，用于取消订阅
+     */
+    int subscribe(Callback callback);
+    
+    /**
+     * @brief 取消订阅
+     * @param subscription_id subscribe返回的订阅编号
+     */
+    void unsubscribe(int subscription_id);
+    
+    /**
+     * @brief 打开追加式变更日志文件
+     * @param filename 日志文件名
+     * @return bool 打开成功返回true
+     * 
+     * 若文件已存在，序列号从文件中最后一个事件继续递增。
+     */
+    bool open_log(const std::string& filename);
+    
+    /**
+     * @brief 关闭变更日志文件
+     */
+    void close_log();
+    
+    /**
+     * @brief 变更日志文件是否已打开
+     * @return bool 已打开返回true
+     */
+    bool is_log_open() const;
+    
+    /**
+     * @brief 发布事件
+     * @param event 事件内容（sequence和timestamp_ms由本函数填写）
+     * @return uint64_t 分配的序列号
+     */
+    uint64_t publish(ChangeEvent event);
+    
+    /**
+     * @brief 有消费者时构造并发布事件，否则只占用一个序列号（见skip）
+     * @param build 返回ChangeEvent的函数，没有消费者时不调用
+     * @return uint64_t 分配的序列号
+     */
+    template<typename Build>
+    uint64_t publish_with(Build&& build) {
+        if (!has_consumers()) return skip();
+        return publish(build());
+    }
+    
+    /**
+     * @brief 发布整体加载的结果
+     * @param students 加载完成后的全部学生
+     * @return uint64_t SNAPSHOT标记的序列号
+     * 
+     * 每名学生占用一个序列号：日志文件中逐行写为ADD事件，直接从名册编码，不复制学生对象；
+     * 之后发布一个SNAPSHOT标记。环形缓冲区清空后只保留该标记，订阅回调也只收到该标记，
+     * 进程内消费者据此通过查询接口重新全量同步。没有消费者时只占用序列号。
+     */
+    uint64_t publish_snapshot(const std::list<Student>& students);
+    
+    /**
+     * @brief 不发布事件，只占用一个序列号
+     * @return uint64_t 占用的序列号
+     * 
+     * 同时清空环形缓冲区，之后才开始轮询的消费者从read_since得到false，重新全量同步。
+     */
+    uint64_t skip();
+    
+    /**
+     * @brief 是否有消费者
+     * @return bool 日志文件已打开、有订阅回调或有人轮询过环形缓冲区返回true
+     */
+    bool has_consumers() const {
+        return log_open_ || subscriber_count_ > 0 || polled_;
+    }
+    
+    /**
+     * @brief 开始批量发布
+     * 
+     * 批量期间日志只写入缓冲，最外层end_batch时统一刷新到文件。可嵌套。
+     */
+    void begin_batch();
+    
+    /**
+     * @brief 结束批量发布
+     */
+    void end_batch();
+    
+    /**
+     * @brief 读取指定序列号之后的事件
+     * @param after_sequence 消费者已处理的最后序列号
+     * @param out 输出参数，追加读取到的事件
+     * @param max_events 最多读取的事件数
+     * @return bool 事件连续返回true；所需事件已被环形缓冲区覆盖返回false，
+     *              此时消费者需要重新全量同步
+     */
+    bool read_since(uint64_t after_sequence, std::vector<ChangeEvent>& out,
+                    size_t max_events = SIZE_MAX) const;
+    
+    /**
+     * @brief 获取最后发布的序列号
+     * @return uint64_t 序列号，尚未发布任何事件时为0
+     */
+    uint64_t last_sequence() const;
+    
+    /**
+     * @brief 将事件编码为一行日志文本（不含换行符）
+     * @param event 事件
+     * @return std::string 格式为"序列号\t时间戳\t类型\t学号\t负载"
+     */
+    static std::string serialize(const ChangeEvent& event);
+    
+    /**
+     * @brief 从一行日志文本解码事件
+     * @param line 日志行
+     * @param event 输出参数，解码得到的事件
+     * @return bool 解码成功返回true
+     */
+    static bool deserialize(const std::string& line, ChangeEvent& event);
+
+private:
+    mutable std::mutex mutex_;             ///< 保护序列号、环形缓冲区和日志文件
+    uint64_t next_sequence_ = 1;           ///< 下一个序列号
+    RingBuffer<ChangeEvent> ring_;         ///< 最近事件环形缓冲区
+    std::ofstream log_;                    ///< 变更日志文件
+    int batch_depth_ = 0;                  ///< 批量发布嵌套深度
+    std::mutex subscribers_mutex_;         ///< 保护订阅回调表（回调在此锁下调用，不持有mutex_）
+    std::map<int, Callback> subscribers_;  ///< 订阅回调（按订阅编号排序）
+    int next_subscription_id_ = 1;         ///< 下一个订阅编号
+    std::atomic<bool> log_open_{false};           ///< 日志文件是否已打开
+    std::atomic<size_t> subscriber_count_{0};     ///< 订阅回调数
+    mutable std::atomic<bool> polled_{false};     ///< 是否有人轮询过环形缓冲区
+    
+    /**
+     * @brief 读取已有日志文件中最后一个事件的序列号
+     * @param filename 日志文件名
+     * @return uint64_t 最后序列号，文件不存在或为空时为0
+     */
+    static uint64_t read_last_sequence(const std::string& filename);
+};
+
+/**
+ * @class ChangeBatch
+ * @brief 批量发布守卫（RAII）
+ * 
+ * 构造时调用begin_batch，析构时调用end_batch。
+ */
+class ChangeBatch {
+public:
+    explicit ChangeBatch(ChangeStream& stream) : stream_(stream) { stream_.begin_batch(); }
+    ~ChangeBatch() { stream_.end_batch(); }
+    ChangeBatch(const ChangeBatch&) = delete;
+    ChangeBatch& operator=(const ChangeBatch&) = delete;
+
+private:
+    ChangeStream& stream_;
+};
@@ -0,0 +1,73 @@
+/**
+ * @file concurrent_id_set.hh
+ * @brief 分片加锁的并发学号集合
+ * 
+ * 按哈希值高位把学号分到若干分片，每个分片有自己的互斥锁和FlatIdMap，
+ * 多个线程同时插入不同分片的学号时互不阻塞。
+ */
+
+#pragma once
+
+#include "flat_id_map.hh"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+/**
+ * @class ConcurrentIdSet
+ * @brief 并发学号集合，每个学号记录声明它的最小序号
+ * 
+ * 多个线程以各自的序号声明学号，无论到达顺序如何，最终都由序号最小者持有，
+ * 因此并发导入时重复学号的去留与单线程按顺序处理的结果一致。
+ */
+class ConcurrentIdSet {
+public:
+    /**
+     * @brief 声明学号
+     * @param key 数值学号
+     * @param rank 声明者的序号（越小越优先）
+     * @return bool 学号此前不在集合中返回true
+     */
+    bool claim(const StudentId& key, uint64_t rank) {
+        uint64_t hash = FlatIdMap<uint64_t>::hash_of(key);
+        Shard& shard = shards_[hash >> (64 - SHARD_BITS)];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        uint64_t* owner = shard.ids.find(key, hash);
+        if (owner) {
+            if (rank < *owner) *owner = rank;
+            return false;
+        }
+        shard.ids.insert_or_assign(key, rank);
+        return true;
+    }
+    
+    /**
+     * @brief 查询持有学号的序号（应在全部声明完成后调用）
+     * @param key 数值学号
+     * @param rank 输出参数，持有者的序号
+     * @return bool 学号在集合中返回true
+     */
+    bool owner(const StudentId& key, uint64_t& rank) const {
+        uint64_t hash = FlatIdMap<uint64_t>::hash_of(key);
+        const Shard& shard = shards_[hash >> (64 - SHARD_BITS)];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const uint64_t* found = shard.ids.find(key, hash);
+        if (!found) return false;
+        rank = *found;
+        return true;
+    }
+
+private:
+    static constexpr unsigned SHARD_BITS = 6;  ///< 分片数为2^6
+    
+    /**
+     * @struct Shard
+     * @brief 分片（按缓存行对齐，避免相邻分片的锁互相干扰）
+     */
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;   ///< 保护本分片
+        FlatIdMap<uint64_t> ids;    ///< 学号->持有者序号
+    };
+    
+    Shard shards_[1u << SHARD_BITS];  ///< 分片
+};
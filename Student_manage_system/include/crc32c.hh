@@ -0,0 +1,27 @@
+/**
+ * @file crc32c.hh
+ * @brief CRC32C（Castagnoli）校验
+ * 
+ * x86-64上运行时检测到SSE4.2时使用crc32指令、ARMv8编译时启用CRC扩展时使用对应指令，
+ * 每条指令处理8字节；其他情况退化为查表法（slicing-by-8）。各实现结果相同。
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief 计算CRC32C
+ * @param data 数据
+ * @param size 长度
+ * @param crc 前面数据的CRC32C，分段计算时传入上一段的结果，首段为0
+ * @return uint32_t 到本段为止的CRC32C，即crc32c(b, n, crc32c(a, m))等于a、b拼接后的结果
+ */
+uint32_t crc32c(const void* data, size_t size, uint32_t crc = 0);
+
+/**
+ * @brief 是否使用CPU指令计算CRC32C
+ * @return bool 使用硬件指令返回true，查表法返回false
+ */
+bool crc32c_uses_hardware();
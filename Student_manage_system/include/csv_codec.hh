@@ -0,0 +1,49 @@
+/**
+ * @file csv_codec.hh
+ * @brief 学生CSV行编解码
+ * 
+ * 提供学生对象与CSV行（学号,姓名,性别,班级,电话,邮箱,成绩信息）之间的转换，
+ * 供文件加载、增量导入和变更日志共用。基本字段的列由student_schema.hh中的字段表展开。
+ */
+
+#pragma once
+
+#include "student.hh"
+#include "student_schema.hh"
+#include <string>
+#include <vector>
+
+/**
+ * @brief 获取CSV表头行（含换行符）
+ * @return const std::string& 表头，各列名取自字段表，最后是成绩信息列
+ */
+const std::string& csv_header();
+
+/**
+ * @brief 将学生对象编码为一行CSV（不含换行符）
+ * @param student 学生对象
+ * @return std::string CSV行，成绩格式为"科目1:成绩1;科目2:成绩2"，无成绩时为"无成绩"
+ */
+std::string student_to_csv(const Student& student);
+
+/**
+ * @brief 将学生对象编码为一行CSV并追加到缓冲区（含换行符）
+ * @param buffer 输出缓冲区
+ * @param student 学生对象
+ * 
+ * 与student_to_csv格式相同，但不构造临时字符串，适合批量导出。
+ */
+void append_student_csv(std::string& buffer, const Student& student);
+
+/**
+ * @brief 从一行CSV解码学生对象
+ * @param line CSV行
+ * @param student 输出参数，解码得到的学生对象
+ * @param skipped_scores 可选输出参数，记录无法解析的"科目=成绩"项
+ * @param columns 需要解析的列，其余列只检查列数，不验证，对应字段保持为空
+ * @return bool 列数正确返回true，格式错误返回false
+ * @throws std::invalid_argument 当需要解析的字段验证失败
+ */
+bool student_from_csv(const std::string& line, Student& student,
+                      std::vector<std::string>* skipped_scores = nullptr,
+                      const ColumnSet& columns = ColumnSet::all());
@@ -0,0 +1,183 @@
+/**
+ * @file flat_id_map.hh
+ * @brief 以数值学号为键的开放寻址哈希表
+ * 
+ * 所有槽位存放在一个连续数组中，线性探测，负载因子不超过1/2，
+ * 查找通常只访问一条缓存行。槽位地址可以由哈希值直接算出，
+ * 因此批量查找时可以先对全部键发出预取，再依次解析。
+ */
+
+#pragma once
+
+#include "student_id.hh"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+/**
+ * @brief 提示CPU预取一条缓存行（不支持的编译器上为空操作）
+ * @param address 将要读取的地址
+ */
+inline void prefetch_read(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address, 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+    (void)address;
+#endif
+}
+
+/**
+ * @class FlatIdMap
+ * @brief 学号->值的开放寻址哈希表
+ * @tparam V 值类型（需可默认构造和复制）
+ * 
+ * 位数为0的学号表示空槽位。删除采用后移法，不留墓碑，
+ * 频繁增删后探测长度不会退化。
+ */
+template<typename V>
+class FlatIdMap {
+public:
+    /**
+     * @brief 计算学号的哈希值（供find和prefetch共用，避免重复计算）
+     * @param key 数值学号
+     * @return uint64_t 哈希值
+     */
+    static uint64_t hash_of(const StudentId& key) { return StudentIdHash()(key); }
+    
+    /**
+     * @brief 查找学号
+     * @param key 数值学号
+     * @param hash hash_of(key)的结果
+     * @return V* 值指针，不存在返回nullptr（插入或删除后失效）
+     */
+    V* find(const StudentId& key, uint64_t hash) {
+        return const_cast<V*>(static_cast<const FlatIdMap*>(this)->find(key, hash));
+    }
+    
+    const V* find(const StudentId& key, uint64_t hash) const {
+        if (size_ == 0) return nullptr;
+        for (size_t i = hash & mask_;; i = (i + 1) & mask_) {
+            const Slot& slot = slots_[i];
+            if (slot.key.length == 0) return nullptr;
+            if (slot.key == key) return &slot.value;
+        }
+    }
+    
+    V* find(const StudentId& key) { return find(key, hash_of(key)); }                    ///< 查找学号
+    const V* find(const StudentId& key) const { return find(key, hash_of(key)); }        ///< 查找学号
+    bool contains(const StudentId& key) const { return find(key) != nullptr; }          ///< 是否包含学号
+    
+    /**
+     * @brief 预取学号所在的槽位
+     * @param hash hash_of(key)的结果
+     */
+    void prefetch(uint64_t hash) const {
+        if (!slots_.empty()) prefetch_read(&slots_[hash & mask_]);
+    }
+    
+    /**
+     * @brief 插入或覆盖
+     * @param key 数值学号（位数不得为0）
+     * @param value 值
+     */
+    void insert_or_assign(const StudentId& key, V value) {
+        if ((size_ + 1) * 2 > slots_.size()) grow((size_ + 1) * 2);
+        size_t i = hash_of(key) & mask_;
+        while (slots_[i].key.length != 0 && slots_[i].key != key) i = (i + 1) & mask_;
+        if (slots_[i].key.length == 0) ++size_;
+        slots_[i].key = key;
+        slots_[i].value = std::move(value);
+    }
+    
+    /**
+     * @brief 删除学号
+     * @param key 数值学号
+     * @return bool 学号存在并被删除返回true
+     */
+    bool erase(const StudentId& key) {
+        if (size_ == 0) return false;
+        size_t i = hash_of(key) & mask_;
+        while (slots_[i].key != key) {
+            if (slots_[i].key.length == 0) return false;
+            i = (i + 1) & mask_;
+        }
+        
+        // 后移法：把探测链上后面、且理想位置不在(i, j]之间的元素移到空位
+        for (size_t j = (i + 1) & mask_; slots_[j].key.length != 0; j = (j + 1) & mask_) {
+            size_t home = hash_of(slots_[j].key) & mask_;
+            bool movable = i <= j ? (home <= i || home > j) : (home <= i && home > j);
+            if (movable) {
+                slots_[i] = std::move(slots_[j]);
+                i = j;
+            }
+        }
+        slots_[i] = Slot();
+        --size_;
+        return true;
+    }
+    
+    /**
+     * @brief 清空（释放槽位数组）
+     */
+    void clear() {
+        slots_.clear();
+        slots_.shrink_to_fit();
+        mask_ = 0;
+        size_ = 0;
+    }
+    
+    size_t size() const { return size_; }        ///< 键数量
+    bool empty() const { return size_ == 0; }     ///< 是否为空
+    
+    /**
+     * @brief 遍历全部键值（顺序不确定）
+     * @tparam F 回调类型，签名为void(const StudentId&, const V&)
+     * @param callback 回调
+     */
+    template<typename F>
+    void for_each(F callback) const {
+        for (const auto& slot : slots_) {
+            if (slot.key.length != 0) callback(slot.key, slot.value);
+        }
+    }
+
+private:
+    /**
+     * @struct Slot
+     * @brief 槽位
+     */
+    struct Slot {
+        StudentId key;  ///< 学号（位数为0表示空槽位）
+        V value{};      ///< 值
+    };
+    
+    std::vector<Slot> slots_;  ///< 槽位数组（长度为2的幂）
+    size_t mask_ = 0;          ///< 槽位数减一
+    size_t size_ = 0;          ///< 键数量
+    
+    /**
+     * @brief 扩容到不小于min_slots的2的幂并重新插入
+     * @param min_slots 最少槽位数
+     */
+    void grow(size_t min_slots) {
+        size_t capacity = 16;
+        while (capacity < min_slots) capacity *= 2;
+        if (capacity <= slots_.size()) return;
+        
+        std::vector<Slot> old(capacity);
+        old.swap(slots_);
+        mask_ = capacity - 1;
+        for (auto& slot : old) {
+            if (slot.key.length == 0) continue;
+            size_t i = hash_of(slot.key) & mask_;
+            while (slots_[i].key.length != 0) i = (i + 1) & mask_;
+            slots_[i] = std::move(slot);
+        }
+    }
+};
@@ -0,0 +1,179 @@
+/**
+ * @file frozen_roster.hh
+ * @brief 只读冻结名册
+ * 
+ * 将学生数据写成一个扁平的只读文件：按最小完美哈希槽位排列的定长记录、
+ * 按姓名和班级排序的二级索引以及字符串区。文件以内存映射方式打开，
+ * 多个进程可以共享同一份物理内存，按学号查询只需一次哈希探测。
+ */
+
+#pragma once
+
+#include "student.hh"
+#include "mapped_file.hh"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <vector>
+
+/**
+ * @class FrozenRoster
+ * @brief 以最小完美哈希组织的只读学生名册
+ * 
+ * 最小完美哈希采用"哈希-位移"构造：学号先落入桶，每个桶选择一个位移值，
+ * 使桶内所有学号映射到互不冲突的槽位，n个学号恰好占满n个槽位。
+ * 文件采用本机字节序，只能在同一架构的机器间共享。
+ */
+class FrozenRoster {
+public:
+    FrozenRoster() = default;
+    
+    /**
+     * @brief 析构函数，解除文件映射
+     */
+    ~FrozenRoster();
+    
+    FrozenRoster(const FrozenRoster&) = delete;
+    FrozenRoster& operator=(const FrozenRoster&) = delete;
+    
+    /**
+     * @brief 将学生列表写成冻结名册文件
+     * @param students 学生列表（学号不得重复）
+     * @param filename 输出文件名
+     * @return bool 写入成功返回true
+     */
+    static bool write(const std::list<Student>& students, const std::string& filename);
+    
+    /**
+     * @brief 以只读方式映射冻结名册文件
+     * @param filename 文件名
+     * @return bool 文件存在且格式正确返回true
+     */
+    bool open(const std::string& filename);
+    
+    /**
+     * @brief 解除映射
+     */
+    void close();
+    
+    /**
+     * @brief 是否已打开
+     * @return bool 已打开返回true
+     */
+    bool is_open() const { return data_ != nullptr; }
+    
+    /**
+     * @brief 获取学生数量
+     * @return size_t 名册中的学生数量
+     */
+    size_t size() const;
+    
+    /**
+     * @brief 查找学号所在槽位（一次哈希探测加一次学号比对）
+     * @param key 数值学号
+     * @return long 槽位编号，学号不存在返回-1
+     */
+    long find_slot(const StudentId& key) const;
+    
+    /**
+     * @brief 读取指定槽位的学生
+     * @param slot 槽位编号
+     * @return Student 学生对象
+     */
+    Student get(size_t slot) const;
+    
+    /**
+     * @brief 根据学号查询学生
+     * @param student_id 学号
+     * @param student 输出参数，找到时写入学生数据
+     * @return bool 找到返回true
+     */
+    bool find_student_by_id(const std::string& student_id, Student& student) const;
+    
+    /**
+     * @brief 按姓名精确查询（二分查找姓名索引）
+     * @param name 姓名
+     * @return std::vector<Student> 匹配的学生，按学号排序
+     */
+    std::vector<Student> find_students_by_name(const std::string& name) const;
+    
+    /**
+     * @brief 按班级查询（二分查找班级索引）
+     * @param class_id 班级号
+     * @return std::vector<Student> 该班级的学生，按学号排序
+     */
+    std::vector<Student> find_students_by_class(const std::string& class_id) const;
+
+private:
+    /**
+     * @struct Header
+     * @brief 文件头
+     */
+    struct Header {
+        char magic[8];             ///< 文件标识"SMSFRZ1"
+        uint32_t count;            ///< 学生数量（也是槽位数）
+        uint32_t bucket_count;     ///< 桶数量
+        uint64_t seed;             ///< 哈希种子
+        uint64_t buckets_offset;   ///< 位移表偏移
+        uint64_t records_offset;   ///< 记录区偏移
+        uint64_t name_index_offset;  ///< 姓名索引偏移
+        uint64_t class_index_offset; ///< 班级索引偏移
+        uint64_t strings_offset;   ///< 字符串区偏移
+        uint64_t file_size;        ///< 文件总长度
+    };
+    
+    /**
+     * @struct Record
+     * @brief 定长学生记录，字符串字段以(偏移, 长度)引用字符串区
+     */
+    struct Record {
+        uint64_t id_low;       ///< 数值学号低位
+        uint8_t id_high;       ///< 数值学号高位
+        uint8_t id_length;     ///< 学号位数
+        uint8_t padding[2];    ///< 对齐填充
+        uint32_t name[2];      ///< 姓名（用于姓名索引）
+        uint32_t class_id[2];  ///< 班级号（用于班级索引）
+        uint32_t row[2];       ///< 完整学生数据（CSV行，格式同csv_codec）
+    };
+    
+    MappedFile file_;             ///< 映射的文件
+    const char* data_ = nullptr;  ///< 文件内容（格式校验通过后才指向file_）
+    
+    const Header& header() const { return *reinterpret_cast<const Header*>(data_); }
+    const Record& record(size_t slot) const;
+    
+    /**
+     * @brief 读取记录中引用的字符串
+     * @param ref (偏移, 长度)
+     * @return std::string 字符串
+     */
+    std::string text(const uint32_t ref[2]) const;
+    
+    /**
+     * @brief 在排序索引中查找与值相等的区间
+     * @param index_offset 索引偏移
+     * @param field 记录中的字段指针成员
+     * @param value 查找值
+     * @return std::vector<Student> 区间内的学生
+     */
+    std::vector<Student> equal_range(uint64_t index_offset, uint32_t (Record::*field)[2],
+                                     const std::string& value) const;
+    
+    /**
+     * @brief 计算学号在给定种子下的哈希值
+     * @param key 数值学号
+     * @param seed 种子
+     * @return uint64_t 哈希值
+     */
+    static uint64_t key_hash(const StudentId& key, uint64_t seed);
+    
+    /**
+     * @brief 计算桶内学号在给定位移下的槽位
+     * @param hash key_hash的结果
+     * @param displacement 位移值
+     * @param count 槽位数
+     * @return uint32_t 槽位编号
+     */
+    static uint32_t slot_of(uint64_t hash, uint32_t displacement, uint32_t count);
+};
@@ -0,0 +1,133 @@
+/**
+ * @file index_file.hh
+ * @brief 持久化索引文件
+ * 
+ * 保存数据文件时把二级索引序列化到旁边的索引文件（数据文件名加".idx"），
+ * 文件头记录数据文件的长度、校验和与学生数量。加载时以内存映射打开，
+ * 三者都与数据文件一致才直接恢复索引，否则视为过期并重新构建。
+ */
+
+#pragma once
+
+#include "mapped_file.hh"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @class IndexFile
+ * @brief 分段存放的索引文件
+ * 
+ * 文件由文件头、段表和各段数据组成，每段是某个索引serialize的输出。
+ * 打开时校验文件自身的校验和，损坏的文件按不存在处理。
+ * 文件采用本机字节序，只能在同一架构的机器间使用。
+ */
+class IndexFile {
+public:
+    /**
+     * @enum Section
+     * @brief 段编号
+     */
+    enum Section : uint32_t {
+        ID_PREFIX = 1,    ///< 学号前缀索引
+        NAME_PREFIX = 2,  ///< 姓名前缀索引
+        ID_FILTER = 3,    ///< 学号布隆过滤器
+        NAME_SEARCH = 4   ///< 姓名拼音/容错索引
+    };
+    
+    /**
+     * @brief 获取数据文件对应的索引文件名
+     * @param data_filename 数据文件名
+     * @return std::string 索引文件名
+     */
+    static std::string path_for(const std::string& data_filename) { return data_filename + ".idx"; }
+    
+    /**
+     * @brief 计算文件内容的64位校验和
+     * @param filename 文件名
+     * @param checksum 输出参数，校验和
+     * @param size 输出参数，文件长度
+     * @return bool 文件可读返回true
+     */
+    static bool checksum_file(const std::string& filename, uint64_t& checksum, uint64_t& size);
+    
+    /**
+     * @brief 写入索引文件（先写临时文件再改名，不会留下不完整的文件）
+     * @param filename 索引文件名
+     * @param data_checksum 数据文件校验和
+     * @param data_size 数据文件长度
+     * @param record_count 数据文件中的学生数量
+     * @param sections (段编号, 段数据)列表
+     * @return bool 写入成功返回true
+     */
+    static bool write(const std::string& filename, uint64_t data_checksum, uint64_t data_size,
+                      uint64_t record_count, const std::vector<std::pair<uint32_t, std::string>>& sections);
+    
+    /**
+     * @brief 以内存映射方式打开索引文件
+     * @param filename 索引文件名
+     * @return bool 文件存在且格式正确返回true
+     */
+    bool open(const std::string& filename);
+    
+    /**
+     * @brief 关闭索引文件
+     */
+    void close();
+    
+    /**
+     * @brief 是否已打开
+     * @return bool 已打开返回true
+     */
+    bool is_open() const { return file_.data() != nullptr; }
+    
+    /**
+     * @brief 判断索引是否对应指定版本的数据文件
+     * @param data_checksum 数据文件校验和
+     * @param data_size 数据文件长度
+     * @param record_count 从数据文件加载的学生数量
+     * @return bool 全部一致返回true
+     */
+    bool matches(uint64_t data_checksum, uint64_t data_size, uint64_t record_count) const;
+    
+    /**
+     * @brief 获取段数据
+     * @param id 段编号
+     * @param data 输出参数，段数据起始地址（指向映射内存，关闭后失效）
+     * @param size 输出参数，段数据长度
+     * @return bool 段存在返回true
+     */
+    bool section(uint32_t id, const char*& data, size_t& size) const;
+
+private:
+    /**
+     * @struct Header
+     * @brief 文件头
+     */
+    struct Header {
+        char magic[8];           ///< 文件标识"SMSIDX1"
+        uint64_t data_size;      ///< 数据文件长度
+        uint64_t data_checksum;  ///< 数据文件校验和
+        uint64_t record_count;   ///< 学生数量
+        uint64_t section_count;  ///< 段数量
+        uint64_t file_size;      ///< 索引文件总长度
+        uint64_t index_checksum; ///< 文件头之后全部内容的校验和（损坏的索引文件不会被使用）
+    };
+    
+    /**
+     * @struct SectionEntry
+     * @brief 段表项
+     */
+    struct SectionEntry {
+        uint32_t id;        ///< 段编号
+        uint32_t padding;   ///< 对齐填充
+        uint64_t offset;    ///< 段数据偏移
+        uint64_t length;    ///< 段数据长度
+    };
+    
+    MappedFile file_;  ///< 映射的索引文件
+    
+    const Header& header() const { return *reinterpret_cast<const Header*>(file_.data()); }
+};
@@ -0,0 +1,242 @@
+/**
+ * @file log_store.hh
+ * @brief 日志结构存储
+ * 
+ * 每次修改都以一条记录追加到当前活动段文件末尾，不改写已有数据；内存索引记录每个学号
+ * 最新版本所在的段和位置。活动段写满后封存并开启新段，后台整理线程在封存段中失效记录
+ * 达到一定比例时把它们合并为一个只含最新版本的基础段（base），再删除旧段，
+ * 使磁盘占用和启动重放时间与有效数据量成正比。
+ * 
+ * 目录中的文件：
+ * - "00000012.log"：日志段，按编号顺序重放
+ * - "00000011.base"：整理生成的基础段，替代编号不大于它的全部段
+ * 
+ * 记录格式（本机字节序）：1字节类型，带长度前缀的学号，带长度前缀的学生二进制记录
+ * （见append_student_binary，删除和清空时为空），
+ * 最后是前面各字段的CRC32C。校验失败的记录与不完整的记录同样处理。
+ */
+
+#pragma once
+
+#include "student.hh"
+#include "student_id.hh"
+#include "flat_id_map.hh"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * @struct LogStoreStats
+ * @brief 日志存储状态
+ */
+struct LogStoreStats {
+    size_t segments = 0;           ///< 段文件数（含活动段和基础段）
+    size_t live_records = 0;       ///< 有效学生数
+    uint64_t total_bytes = 0;      ///< 全部段文件的字节数
+    uint64_t dead_bytes = 0;       ///< 其中已被覆盖或删除的记录字节数
+    size_t compactions = 0;        ///< 本次打开以来完成的整理次数
+    uint64_t compacted_bytes = 0;  ///< 整理写出的字节数
+    bool compaction_failed = false; ///< 最近一次整理是否失败
+};
+
+/**
+ * @class LogStore
+ * @brief 追加写入的学生记录存储，后台整理
+ * 
+ * 线程安全：写入、遍历和整理可以在不同线程进行。后台整理线程不写日志。
+ */
+class LogStore {
+public:
+    static constexpr uint64_t SEGMENT_SIZE = 8 << 20;        ///< 活动段达到该长度后封存
+    static constexpr uint64_t COMPACT_MIN_BYTES = 8 << 20;   ///< 封存段总长度达到该值才考虑整理
+    static constexpr unsigned COMPACT_DEAD_PERCENT = 50;     ///< 封存段中失效记录占比达到该值时整理
+    
+    LogStore() = default;
+    
+    /**
+     * @brief 析构函数，停止后台整理并关闭文件
+     */
+    ~LogStore();
+    
+    LogStore(const LogStore&) = delete;
+    LogStore& operator=(const LogStore&) = delete;
+    
+    /**
+     * @brief 打开（或创建）存储目录，重放全部段重建索引并启动后台整理线程
+     * @param directory 存储目录
+     * @return bool 打开成功返回true
+     * 
+     * 最后一个日志段末尾不完整或校验失败的记录（写入中途崩溃）及其后的数据会被截掉；
+     * 其他段损坏时打开失败。
+     */
+    bool open(const std::string& directory);
+    
+    /**
+     * @brief 停止后台整理并关闭文件
+     */
+    void close();
+    
+    /**
+     * @brief 写入学生的最新版本
+     * @param student 学生
+     * @return bool 写入成功返回true
+     */
+    bool put(const Student& student);
+    
+    /**
+     * @brief 写入删除标记
+     * @param key 数值学号
+     * @return bool 写入成功返回true
+     */
+    bool erase(const StudentId& key);
+    
+    /**
+     * @brief 写入清空标记，之前的全部记录失效
+     * @return bool 写入成功返回true
+     */
+    bool clear();
+    
+    /**
+     * @brief 开始批量写入
+     * 
+     * 批量期间记录只写入缓冲，最外层end_batch时统一刷新到文件。可嵌套。
+     */
+    void begin_batch();
+    
+    /**
+     * @brief 结束批量写入
+     */
+    void end_batch();
+    
+    /**
+     * @brief 按写入顺序遍历每个学生的最新版本
+     * @param visit 对每条有效记录的学生二进制记录调用，用student_from_binary解码
+     * @return bool 全部段读取成功返回true
+     */
+    bool for_each_live(const std::function<void(const std::string& data)>& visit);
+    
+    /**
+     * @brief 立即整理全部封存段（后台线程也调用此函数）
+     * @return bool 整理成功或无需整理返回true
+     */
+    bool compact();
+    
+    /**
+     * @brief 获取存储状态
+     * @return LogStoreStats 状态快照
+     */
+    LogStoreStats stats() const;
+    
+    bool is_open() const { return !directory_.empty(); }  ///< 是否已打开
+    size_t size() const;                                  ///< 有效学生数
+
+private:
+    /**
+     * @struct Location
+     * @brief 记录在段文件中的位置
+     */
+    struct Location {
+        uint32_t segment = 0;  ///< 段编号
+        uint32_t length = 0;   ///< 记录长度
+        uint64_t offset = 0;   ///< 记录在段文件中的偏移
+        
+        bool operator==(const Location& other) const {
+            return segment == other.segment && offset == other.offset;
+        }
+    };
+    
+    /**
+     * @struct Segment
+     * @brief 一个段文件
+     */
+    struct Segment {
+        std::string path;    ///< 文件路径
+        uint64_t bytes = 0;  ///< 文件长度
+        uint64_t dead = 0;   ///< 失效记录字节数
+    };
+    
+    std::string directory_;              ///< 存储目录（为空表示未打开）
+    mutable std::mutex mutex_;           ///< 保护以下成员
+    FlatIdMap<Location> index_;          ///< 学号->最新版本位置
+    std::map<uint32_t, Segment> segments_; ///< 段编号->段文件（按编号排序）
+    std::ofstream active_;               ///< 活动段
+    uint32_t active_id_ = 0;             ///< 活动段编号
+    int batch_depth_ = 0;                ///< 批量写入嵌套深度
+    uint64_t sealed_bytes_ = 0;          ///< 封存段（活动段以外）总长度
+    uint64_t sealed_dead_ = 0;           ///< 封存段中失效记录字节数
+    size_t compactions_ = 0;             ///< 完成的整理次数
+    uint64_t compacted_bytes_ = 0;       ///< 整理写出的字节数
+    uint32_t failed_compaction_ = 0;     ///< 整理失败时的活动段编号，新段封存前不再自动重试
+    bool stopping_ = false;              ///< 通知后台线程退出
+    std::mutex compact_mutex_;           ///< 保证同一时间只有一次整理
+    std::condition_variable wake_;       ///< 唤醒后台整理线程
+    std::thread compactor_;              ///< 后台整理线程
+    
+    /**
+     * @brief 追加一条记录并更新索引（调用方持有mutex_）
+     * @param type 记录类型
+     * @param key 数值学号
+     * @param id 学号文本
+     * @param data 学生二进制记录
+     * @return bool 写入成功返回true
+     */
+    bool append(uint8_t type, const StudentId& key, const std::string& id, const std::string& data);
+    
+    /**
+     * @brief 按一条记录更新索引和失效统计（调用方持有mutex_）
+     * @param type 记录类型
+     * @param key 数值学号
+     * @param location 记录位置
+     */
+    void apply(uint8_t type, const StudentId& key, const Location& location);
+    
+    /**
+     * @brief 累加段的失效字节数（调用方持有mutex_）
+     * @param segment 段编号
+     * @param bytes 字节数
+     */
+    void add_dead(uint32_t segment, uint64_t bytes);
+    
+    /**
+     * @brief 封存活动段并开启下一个段（调用方持有mutex_）
+     * @return bool 新段创建成功返回true
+     */
+    bool roll();
+    
+    /**
+     * @brief 是否应当后台整理（调用方持有mutex_）
+     * @return bool 封存段足够大且失效比例达到阈值返回true
+     */
+    bool should_compact() const;
+    
+    /**
+     * @brief 段文件路径
+     * @param id 段编号
+     * @param base 是否为基础段
+     * @return std::string 路径
+     */
+    std::string segment_path(uint32_t id, bool base) const;
+};
+
+/**
+ * @class LogBatch
+ * @brief 日志存储批量写入守卫（RAII）
+ * 
+ * 构造时调用begin_batch，析构时调用end_batch；存储未打开时也可使用。
+ */
+class LogBatch {
+public:
+    explicit LogBatch(LogStore& store) : store_(store) { store_.begin_batch(); }
+    ~LogBatch() { store_.end_batch(); }
+    LogBatch(const LogBatch&) = delete;
+    LogBatch& operator=(const LogBatch&) = delete;
+
+private:
+    LogStore& store_;
+};
@@ -0,0 +1,54 @@
+/**
+ * @file mapped_file.hh
+ * @brief 只读内存映射文件
+ * 
+ * 冻结名册和持久化索引文件共用的只读映射封装。
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @class MappedFile
+ * @brief 以只读方式映射整个文件
+ * 
+ * 支持mmap的平台按MAP_SHARED映射，多个进程共享同一份页缓存；
+ * 其他平台整体读入内存。
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    
+    /**
+     * @brief 析构函数，解除映射
+     */
+    ~MappedFile();
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    /**
+     * @brief 映射文件
+     * @param filename 文件名
+     * @param min_size 文件最小长度（通常为文件头大小）
+     * @return bool 文件存在、长度足够且映射成功返回true
+     */
+    bool open(const std::string& filename, size_t min_size = 0);
+    
+    /**
+     * @brief 解除映射
+     */
+    void close();
+    
+    const char* data() const { return data_; }   ///< 文件内容，未打开时为nullptr
+    size_t size() const { return size_; }        ///< 文件长度
+
+private:
+    const char* data_ = nullptr;  ///< 映射的文件内容
+    size_t size_ = 0;             ///< 映射长度
+    std::vector<char> buffer_;    ///< 不支持内存映射时读入的文件内容
+    bool mapped_ = false;         ///< data_是否来自内存映射
+};
@@ -0,0 +1,129 @@
+/**
+ * @file name_search.hh
+ * @brief 姓名拼音/容错搜索索引
+ * 
+ * 为姓名建立汉字BK树和拼音BK树，支持按全拼、拼音首字母或带错别字的姓名查找，
+ * 返回按编辑距离排序的近似匹配结果。
+ */
+
+#pragma once
+
+#include "bk_tree.hh"
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @struct NameSearchResult
+ * @brief 近似匹配的姓名
+ */
+struct NameSearchResult {
+    std::string name;  ///< 姓名
+    int distance = 0;  ///< 与查询串的编辑距离（0为精确或首字母匹配）
+};
+
+/**
+ * @class NameSearchIndex
+ * @brief 姓名近似搜索索引（支持重复姓名）
+ * 
+ * 内置常用姓氏和名字用字的拼音表（每个字只取一个读音），
+ * 可通过load_pinyin_table补充或覆盖。
+ */
+class NameSearchIndex {
+public:
+    /**
+     * @brief 构造函数，加载内置拼音表
+     */
+    NameSearchIndex();
+    
+    /**
+     * @brief 插入姓名（允许重复）
+     * @param name 姓名
+     */
+    void insert(const std::string& name);
+    
+    /**
+     * @brief 删除姓名的一次出现
+     * @param name 姓名
+     */
+    void erase(const std::string& name);
+    
+    /**
+     * @brief 清空索引（保留拼音表）
+     */
+    void clear();
+    
+    /**
+     * @brief 从文件补充拼音表并重建拼音索引
+     * @param filename 文件名，每行格式为"字,拼音"
+     * @return size_t 成功读取的条目数，文件无法打开返回0
+     */
+    size_t load_pinyin_table(const std::string& filename);
+    
+    /**
+     * @brief 将姓名转换为全拼（无分隔符，拼音表中没有的字符原样保留）
+     * @param name 姓名
+     * @return std::string 全拼
+     */
+    std::string to_pinyin(const std::string& name) const;
+    
+    /**
+     * @brief 将姓名转换为拼音首字母
+     * @param name 姓名
+     * @return std::string 首字母串
+     */
+    std::string to_initials(const std::string& name) const;
+    
+    /**
+     * @brief 近似搜索
+     * @param query 查询串：字母按全拼或首字母匹配，汉字按字形和读音匹配
+     * @param max_distance 最大编辑距离（另按查询长度收紧，避免短查询匹配过多）
+     * @param max_visits 每棵BK树最多访问的节点数，用于限制单次查询耗时
+     * @return std::vector<NameSearchResult> 按距离、姓名排序的不同姓名
+     */
+    std::vector<NameSearchResult> search(const std::string& query, int max_distance,
+                                         size_t max_visits = 20000) const;
+    
+    /**
+     * @brief 将姓名计数和两棵BK树追加到缓冲区
+     * @param out 输出缓冲区
+     * 
+     * 同时写入拼音表指纹，拼音表变化后保存的拼音树不再可用。
+     */
+    void serialize(std::string& out) const;
+    
+    /**
+     * @brief 从serialize的输出恢复索引，拼音映射由姓名重新计算
+     * @param data 数据起始地址
+     * @param size 数据长度
+     * @return bool 数据完整且拼音表指纹一致返回true，失败时索引保持不变
+     */
+    bool deserialize(const char* data, size_t size);
+
+private:
+    std::unordered_map<char32_t, std::string> pinyin_table_;  ///< 汉字->拼音
+    std::unordered_map<std::string, size_t> names_;           ///< 姓名->出现次数
+    std::unordered_map<std::string, std::set<std::string>> by_pinyin_;   ///< 全拼->姓名
+    std::unordered_map<std::string, std::set<std::string>> by_initials_; ///< 首字母->姓名
+    BKTree name_tree_;     ///< 以姓名为键的BK树
+    BKTree pinyin_tree_;   ///< 以全拼为键的BK树
+    
+    /**
+     * @brief 将不同姓名加入拼音索引
+     * @param name 姓名
+     */
+    void index_pinyin(const std::string& name);
+    
+    /**
+     * @brief 将不同姓名移出拼音索引
+     * @param name 姓名
+     */
+    void unindex_pinyin(const std::string& name);
+    
+    /**
+     * @brief 计算拼音表指纹（与条目顺序无关）
+     * @return uint64_t 指纹
+     */
+    uint64_t table_fingerprint() const;
+};
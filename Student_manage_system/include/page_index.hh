@@ -0,0 +1,161 @@
+/**
+ * @file page_index.hh
+ * @brief 分页列表的有序索引
+ * 
+ * 按一种排序键维护全部学生的顺序，翻页时从令牌中的游标位置直接定位到下一名学生，
+ * 每页的耗时与页大小和名册规模的对数有关，不再随已翻过的页数增长。
+ */
+
+#pragma once
+
+#include "student.hh"
+#include "student_id.hh"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <vector>
+
+/**
+ * @enum StudentSortKey
+ * @brief 分页列表的排序键（键相同时按学号排序）
+ */
+enum class StudentSortKey {
+    ID,             ///< 按学号升序
+    NAME,           ///< 按姓名升序
+    CLASS_ID,       ///< 按班级号升序
+    AVERAGE_SCORE   ///< 按平均分降序
+};
+
+/**
+ * @struct PageKey
+ * @brief 学生在分页顺序中的位置
+ */
+struct PageKey {
+    std::string text;      ///< 姓名或班级号（按姓名、班级号排序时使用）
+    float average = 0.0f;  ///< 平均分（按平均分排序时使用）
+    StudentId id;          ///< 学号（排序值相同时比较）
+};
+
+/**
+ * @class PageIndex
+ * @brief 按一种排序键有序的学生位置集合
+ * 
+ * 以树堆（treap）实现，节点存放在连续数组中，以下标代替指针，空闲节点串成链表复用。
+ * 每个节点记录子树大小，定位游标时同时得到它之前的学生数，剩余人数不必再遍历。
+ * 节点优先级取学号的哈希值，同一名册得到的树形状相同。
+ */
+class PageIndex {
+public:
+    /**
+     * @brief 构造函数
+     * @param key 排序键
+     */
+    explicit PageIndex(StudentSortKey key);
+    
+    /**
+     * @brief 计算学生在本索引顺序中的位置
+     * @param student 学生
+     * @return PageKey 位置（只填写本排序键用到的字段）
+     */
+    PageKey key_of(const Student& student) const;
+    
+    /**
+     * @brief 比较两个位置的先后（排序值相同时比较学号）
+     * @param a 第一个位置
+     * @param b 第二个位置
+     * @return bool a排在b前面返回true
+     */
+    bool before(const PageKey& a, const PageKey& b) const;
+    
+    /**
+     * @brief 加入学生（须尚未加入）
+     * @param student 学生
+     */
+    void insert(const Student& student);
+    
+    /**
+     * @brief 移除学生（须为加入时的状态）
+     * @param student 学生
+     */
+    void erase(const Student& student);
+    
+    /**
+     * @brief 用整个名册重建索引：先排序，再按优先级线性时间建树
+     * @param students 名册
+     */
+    void build(const std::list<Student>& students);
+    
+    /**
+     * @brief 取游标之后的一页
+     * @param cursor 上一页最后一名学生的位置，为nullptr时从第一名开始
+     * @param count 最多取的学生数
+     * @param ids 输出参数，本页学生的学号，按顺序排列
+     * @return size_t 本页之后还剩余的学生数
+     */
+    size_t page_after(const PageKey* cursor, size_t count, std::vector<StudentId>& ids) const;
+    
+    /**
+     * @brief 获取学生数
+     * @return size_t 学生数
+     */
+    size_t size() const { return root_ == NIL ? 0 : nodes_[root_].size; }
+
+private:
+    static constexpr uint32_t NIL = 0xFFFFFFFFu; ///< 空节点下标
+    
+    /**
+     * @struct Node
+     * @brief 树堆节点
+     */
+    struct Node {
+        PageKey key;               ///< 学生位置
+        uint32_t priority = 0;     ///< 优先级（大的靠近根）
+        uint32_t left = NIL;       ///< 左子树（空闲节点用作下一个空闲节点）
+        uint32_t right = NIL;      ///< 右子树
+        uint32_t size = 1;         ///< 子树中的学生数
+    };
+    
+    StudentSortKey sort_key_;      ///< 排序键
+    std::vector<Node> nodes_;      ///< 节点数组
+    uint32_t root_ = NIL;          ///< 根节点
+    uint32_t free_ = NIL;          ///< 空闲节点链表
+    
+    /**
+     * @brief 分配一个节点
+     * @param key 学生位置
+     * @return uint32_t 节点下标
+     */
+    uint32_t allocate(PageKey key);
+    
+    /**
+     * @brief 子树大小
+     * @param node 节点下标（可为NIL）
+     * @return uint32_t 学生数
+     */
+    uint32_t size_of(uint32_t node) const { return node == NIL ? 0 : nodes_[node].size; }
+    
+    /**
+     * @brief 按子节点重新计算子树大小
+     * @param node 节点下标
+     */
+    void update(uint32_t node);
+    
+    /**
+     * @brief 按位置拆分子树
+     * @param node 子树根
+     * @param key 拆分位置
+     * @param inclusive true时等于key的节点分到左边
+     * @param left 输出参数，排在key前面（inclusive时含key）的节点
+     * @param right 输出参数，其余节点
+     */
+    void split(uint32_t node, const PageKey& key, bool inclusive, uint32_t& left, uint32_t& right);
+    
+    /**
+     * @brief 合并两棵子树（left中的节点都排在right前面）
+     * @param left 左子树根
+     * @param right 右子树根
+     * @return uint32_t 合并后的根
+     */
+    uint32_t merge(uint32_t left, uint32_t right);
+};
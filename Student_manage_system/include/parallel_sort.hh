@@ -0,0 +1,64 @@
+/**
+ * @file parallel_sort.hh
+ * @brief 并行稳定归并排序
+ * 
+ * 对下标排列排序而不移动元素本身：先把排列分成若干段在各线程中稳定排序，
+ * 再逐轮两两归并。std::merge在相等时先取左段元素，因此整体排序是稳定的。
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 并行稳定排序下标排列
+ * @tparam Compare 比较函数类型，签名为bool(uint32_t, uint32_t)
+ * @param order 下标排列（就地排序）
+ * @param less 严格弱序比较函数（多个线程会同时调用，须无副作用）
+ * @param threads 线程数，0表示按硬件并发数
+ * 
+ * 元素较少或只有一个线程时退化为std::stable_sort。
+ */
+template<typename Compare>
+void parallel_stable_sort(std::vector<uint32_t>& order, Compare less, size_t threads = 0) {
+    constexpr size_t MIN_PARALLEL = 1 << 14;  ///< 少于该数量时线程开销大于收益
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    
+    // 段数取不超过线程数的2的幂，使每轮归并的段数都能两两配对
+    size_t runs = 1;
+    while (runs * 2 <= threads && order.size() / (runs * 2) >= MIN_PARALLEL) runs *= 2;
+    if (runs == 1) {
+        std::stable_sort(order.begin(), order.end(), less);
+        return;
+    }
+    
+    std::vector<size_t> bounds(runs + 1);
+    for (size_t i = 0; i <= runs; ++i) bounds[i] = order.size() * i / runs;
+    
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < runs; ++i) {
+        workers.emplace_back([&order, &bounds, &less, i]() {
+            std::stable_sort(order.begin() + bounds[i], order.begin() + bounds[i + 1], less);
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    
+    std::vector<uint32_t> buffer(order.size());
+    for (size_t width = 1; width < runs; width *= 2) {
+        workers.clear();
+        for (size_t i = 0; i < runs; i += 2 * width) {
+            workers.emplace_back([&order, &buffer, &bounds, &less, i, width]() {
+                auto first = order.begin() + bounds[i];
+                auto middle = order.begin() + bounds[i + width];
+                auto last = order.begin() + bounds[i + 2 * width];
+                std::merge(first, middle, middle, last, buffer.begin() + bounds[i], less);
+            });
+        }
+        for (auto& worker : workers) worker.join();
+        order.swap(buffer);
+    }
+}
@@ -0,0 +1,130 @@
+/**
+ * @file prefix_index.hh
+ * @brief 前缀索引（字典树）
+ * 
+ * 按字节组织的字典树，支持前缀补全和"您是不是要找"提示，用于学号和姓名的交互式输入。
+ * 节点存放在连续数组中，以下标代替指针，子节点按字节值有序排列。
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @class PrefixIndex
+ * @brief 支持重复键的字节字典树
+ * 
+ * 每个节点记录其子树中的键数量，补全耗时只与前缀长度和返回结果数有关，与总键数无关。
+ * 删除键后计数变为0的子树从父节点摘下；摘下的节点超过节点数组的一半时压缩数组，
+ * 因此反复增删不同的键时内存占用不超过现存节点的两倍。
+ */
+class PrefixIndex {
+public:
+    /**
+     * @brief 构造函数
+     */
+    PrefixIndex();
+    
+    /**
+     * @brief 插入键（允许重复）
+     * @param key 键
+     */
+    void insert(const std::string& key);
+    
+    /**
+     * @brief 删除键的一次出现
+     * @param key 键
+     * @return bool 键存在并被删除返回true
+     */
+    bool erase(const std::string& key);
+    
+    /**
+     * @brief 前缀补全
+     * @param prefix 前缀
+     * @param limit 最多返回的键数
+     * @return std::vector<std::string> 以prefix开头的不同键，按字节序排列
+     */
+    std::vector<std::string> complete(const std::string& prefix, size_t limit) const;
+    
+    /**
+     * @brief "您是不是要找"提示
+     * @param input 用户输入
+     * @param limit 最多返回的键数
+     * @return std::vector<std::string> 与input共享最长前缀的键，按字节序排列
+     */
+    std::vector<std::string> suggest(const std::string& input, size_t limit) const;
+    
+    /**
+     * @brief 清空索引
+     */
+    void clear();
+    
+    /**
+     * @brief 获取键的总数（含重复）
+     * @return size_t 键数量
+     */
+    size_t size() const { return nodes_[0].count; }
+    
+    /**
+     * @brief 获取节点数组的长度（含已摘下、尚未压缩的节点）
+     * @return size_t 节点数
+     */
+    size_t node_count() const { return nodes_.size(); }
+    
+    /**
+     * @brief 将节点数组追加到缓冲区
+     * @param out 输出缓冲区
+     */
+    void serialize(std::string& out) const;
+    
+    /**
+     * @brief 从serialize的输出恢复索引
+     * @param data 数据起始地址
+     * @param size 数据长度
+     * @return bool 数据完整且节点下标合法返回true，失败时索引保持不变
+     */
+    bool deserialize(const char* data, size_t size);
+
+private:
+    static constexpr uint32_t NIL = 0xFFFFFFFFu; ///< 空节点下标
+    
+    /**
+     * @struct Node
+     * @brief 字典树节点
+     */
+    struct Node {
+        uint32_t first_child = NIL;   ///< 第一个子节点
+        uint32_t next_sibling = NIL;  ///< 下一个兄弟节点（按字节值递增）
+        uint32_t count = 0;           ///< 子树中的键数量（含重复）
+        uint32_t terminal = 0;        ///< 恰好以本节点结束的键数量
+        unsigned char byte = 0;       ///< 到达本节点的字节
+    };
+    
+    std::vector<Node> nodes_;  ///< 节点数组，下标0为根
+    size_t dead_nodes_ = 0;    ///< 已从树上摘下、仍占用数组的节点数
+    
+    /**
+     * @brief 查找子节点
+     * @param node 父节点下标
+     * @param byte 字节
+     * @return uint32_t 子节点下标，不存在返回NIL
+     */
+    uint32_t find_child(uint32_t node, unsigned char byte) const;
+    
+    /**
+     * @brief 从指定节点开始按字节序收集键
+     * @param node 起始节点
+     * @param prefix 到达起始节点的前缀
+     * @param limit 最多收集的键数
+     * @param out 输出参数，收集到的键
+     */
+    void collect(uint32_t node, std::string& prefix, size_t limit, std::vector<std::string>& out) const;
+    
+    /**
+     * @brief 按广度优先顺序复制仍有键的节点，得到不含已摘下节点的数组
+     * @return std::vector<Node> 压缩后的节点数组
+     */
+    std::vector<Node> live_nodes() const;
+};
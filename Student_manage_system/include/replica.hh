@@ -0,0 +1,145 @@
+/**
+ * @file replica.hh
+ * @brief 只读副本
+ * 
+ * 副本进程持续追读主实例写出的变更日志（见ChangeStream::open_log），
+ * 在自己的内存中重放变更，并对外提供只读查询，使报表查询不与交互式修改竞争。
+ */
+
+#pragma once
+
+#include "system.hh"
+#include "logger.hh"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @struct ReplicaLag
+ * @brief 副本复制延迟指标
+ */
+struct ReplicaLag {
+    uint64_t applied_sequence = 0;      ///< 已应用的最后序列号
+    size_t applied_events = 0;          ///< 累计应用的事件数
+    size_t skipped_events = 0;          ///< 累计跳过的无法解析或应用失败的事件数
+    uint64_t pending_bytes = 0;         ///< 日志中尚未读取的字节数
+    int64_t last_event_timestamp_ms = 0; ///< 最后应用事件在主实例上的产生时间（Unix毫秒）
+    int64_t apply_delay_ms = 0;         ///< 最后应用事件从产生到在副本上应用的耗时
+    int64_t staleness_ms = 0;           ///< 当前时间距最后应用事件产生的时间
+};
+
+/**
+ * @class StudentReplica
+ * @brief 由变更日志驱动的只读副本
+ * 
+ * 所有查询返回数据副本，可与后台追读线程并发调用。追读时在锁外读取和解码日志，
+ * 每解码APPLY_BATCH个事件持一次写锁应用，追赶长日志期间查询只需等待一个批次。
+ */
+class StudentReplica {
+public:
+    static constexpr size_t APPLY_BATCH = 1024;  ///< 每次持写锁应用的最多事件数
+    
+    /**
+     * @brief 构造函数
+     * @param log_filename 主实例写出的变更日志文件名
+     */
+    explicit StudentReplica(std::string log_filename);
+    
+    /**
+     * @brief 析构函数，停止后台追读线程
+     */
+    ~StudentReplica();
+    
+    StudentReplica(const StudentReplica&) = delete;
+    StudentReplica& operator=(const StudentReplica&) = delete;
+    
+    /**
+     * @brief 启动后台追读线程
+     * @param poll_interval 轮询日志文件的间隔
+     */
+    void start(std::chrono::milliseconds poll_interval = std::chrono::milliseconds(200));
+    
+    /**
+     * @brief 停止后台追读线程
+     */
+    void stop();
+    
+    /**
+     * @brief 读取并应用日志中新增的事件
+     * @return size_t 本次应用的事件数
+     * 
+     * 日志文件被截断或替换（长度小于已读位置，或第一行与之前读到的不同）时，副本清空并从头重放。
+     * 第一行含主实例写入的序列号和时间戳，新日志即使长度不小于旧日志也能识别出来。
+     */
+    size_t poll();
+    
+    /**
+     * @brief 根据学号查询学生
+     * @param student_id 学号
+     * @param student 输出参数，找到时写入学生数据
+     * @return bool 找到返回true
+     */
+    bool find_student_by_id(const std::string& student_id, Student& student);
+    
+    /**
+     * @brief 根据姓名模糊查询学生
+     * @param name 姓名（包含匹配）
+     * @return std::vector<Student> 匹配的学生数据
+     */
+    std::vector<Student> find_students_by_name(const std::string& name);
+    
+    /**
+     * @brief 获取学生成绩信息
+     * @param student_id 学号
+     * @return std::string 格式化的成绩信息字符串
+     */
+    std::string get_student_scores_info(const std::string& student_id);
+    
+    /**
+     * @brief 获取学生数量
+     * @return size_t 副本中的学生数量
+     */
+    size_t get_student_count();
+    
+    /**
+     * @brief 获取复制延迟指标
+     * @return ReplicaLag 延迟指标快照
+     */
+    ReplicaLag lag();
+
+private:
+    std::string log_filename_;        ///< 变更日志文件名
+    std::mutex poll_mutex_;           ///< 串行化poll，保护以下追读状态
+    std::atomic<uint64_t> offset_{0}; ///< 已读取到的文件位置（lag不加poll_mutex_读取）
+    std::string partial_line_;        ///< 尚未读到换行符的不完整行
+    std::string first_line_;          ///< 日志第一行（含换行符），用于识别日志是否被替换
+    StudentManagementSystem store_;   ///< 副本内存数据
+    ReplicaLag lag_;                  ///< 复制延迟指标
+    std::shared_mutex mutex_;         ///< 保护store_和lag_：应用事件持写锁，查询持读锁
+    std::thread tail_thread_;         ///< 后台追读线程
+    std::atomic<bool> running_{false}; ///< 后台线程运行标志
+    std::mutex wait_mutex_;           ///< 后台线程等待用互斥量
+    std::condition_variable wait_cv_; ///< 用于及时唤醒等待中的后台线程
+    Logger logger_;                   ///< 日志记录器实例
+    
+    /**
+     * @brief 应用单个事件（调用方持有mutex_写锁）
+     * @param event 变更事件
+     * @return bool 应用成功返回true
+     */
+    bool apply(const ChangeEvent& event);
+    
+    /**
+     * @brief 判断日志文件是否仍是之前追读的那一个（调用方持有poll_mutex_）
+     * @param file 已打开的日志文件
+     * @return bool 第一行与记录的一致或尚未记录返回true
+     */
+    bool same_log(std::ifstream& file) const;
+};
@@ -0,0 +1,92 @@
+/**
+ * @file ring_buffer.hh
+ * @brief 定长环形缓冲区模板
+ * 
+ * 容量固定，写满后覆盖最旧的元素，支持按逻辑下标访问和从尾部弹出。
+ */
+
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <stdexcept>
+
+/**
+ * @class RingBuffer
+ * @brief 定长环形缓冲区
+ * @tparam T 元素类型（需可默认构造）
+ * 
+ * 逻辑下标0为最旧元素，size()-1为最新元素。所有操作均为O(1)。
+ */
+template<typename T>
+class RingBuffer {
+public:
+    /**
+     * @brief 构造函数
+     * @param capacity 最大容量（至少为1）
+     */
+    explicit RingBuffer(size_t capacity) : slots_(capacity > 0 ? capacity : 1) {}
+    
+    /**
+     * @brief 追加元素，缓冲区已满时覆盖最旧元素
+     * @param value 要追加的元素
+     * @return bool 发生覆盖返回true
+     */
+    bool push_back(T value) {
+        bool overwritten = size_ == slots_.size();
+        slots_[(head_ + size_) % slots_.size()] = std::move(value);
+        if (overwritten) {
+            head_ = (head_ + 1) % slots_.size();
+        } else {
+            ++size_;
+        }
+        return overwritten;
+    }
+    
+    /**
+     * @brief 弹出最新元素
+     * @return T 被弹出的元素
+     * @throws std::out_of_range 当缓冲区为空
+     */
+    T pop_back() {
+        if (size_ == 0) throw std::out_of_range("环形缓冲区为空");
+        --size_;
+        return std::move(slots_[(head_ + size_) % slots_.size()]);
+    }
+    
+    /**
+     * @brief 弹出最旧元素
+     * @return T 被弹出的元素
+     * @throws std::out_of_range 当缓冲区为空
+     */
+    T pop_front() {
+        if (size_ == 0) throw std::out_of_range("环形缓冲区为空");
+        T value = std::move(slots_[head_]);
+        head_ = (head_ + 1) % slots_.size();
+        --size_;
+        return value;
+    }
+    
+    /**
+     * @brief 按逻辑下标访问元素
+     * @param index 逻辑下标（0为最旧元素）
+     * @return const T& 元素常量引用
+     */
+    const T& at(size_t index) const {
+        if (index >= size_) throw std::out_of_range("环形缓冲区下标越界");
+        return slots_[(head_ + index) % slots_.size()];
+    }
+    
+    T& back() { return slots_[(head_ + size_ - 1) % slots_.size()]; } ///< 最新元素（调用前需保证非空）
+    const T& back() const { return slots_[(head_ + size_ - 1) % slots_.size()]; } ///< 最新元素
+    
+    size_t size() const { return size_; }                 ///< 当前元素个数
+    size_t capacity() const { return slots_.size(); }     ///< 最大容量
+    bool empty() const { return size_ == 0; }             ///< 是否为空
+    void clear() { head_ = 0; size_ = 0; }                ///< 清空（不释放槽位）
+
+private:
+    std::vector<T> slots_;  ///< 存储槽位
+    size_t head_ = 0;       ///< 最旧元素所在槽位
+    size_t size_ = 0;       ///< 当前元素个数
+};
@@ -0,0 +1,141 @@
+/**
+ * @file score_rank.hh
+ * @brief 成绩排名索引
+ * 
+ * 成绩范围固定为0-100分，按0.1分精度划分为1001个桶，每个(范围, 科目)维护一棵
+ * 树状数组记录各桶人数。设置成绩时更新O(log B)，查询排名也是O(log B)，
+ * 与学生人数无关（B为桶数）。
+ */
+
+#pragma once
+
+#include "student.hh"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @struct ScoreRank
+ * @brief 排名结果
+ */
+struct ScoreRank {
+    size_t rank = 0;   ///< 名次（比该成绩高的人数加一，同分同名次）
+    size_t total = 0;  ///< 参与排名的人数
+};
+
+/**
+ * @class FenwickTree
+ * @brief 树状数组（单点加、前缀和）
+ */
+class FenwickTree {
+public:
+    /**
+     * @brief 构造函数
+     * @param size 下标范围[0, size)
+     */
+    explicit FenwickTree(size_t size) : tree_(size + 1, 0) {}
+    
+    /**
+     * @brief 单点加
+     * @param index 下标
+     * @param delta 增量
+     */
+    void add(size_t index, int32_t delta);
+    
+    /**
+     * @brief 前缀和
+     * @param index 下标
+     * @return int64_t 下标[0, index]的和
+     */
+    int64_t prefix_sum(size_t index) const;
+
+private:
+    std::vector<int32_t> tree_;  ///< 树状数组（下标从1开始）
+};
+
+/**
+ * @class ScoreRankIndex
+ * @brief 全校和各班级的分科目及平均分排名
+ * 
+ * 科目名为空表示平均分；没有任何成绩的学生不参与平均分排名。
+ * 成绩按0.1分取整后比较，相差不足0.05分视为同分。
+ */
+class ScoreRankIndex {
+public:
+    /**
+     * @brief 加入学生的全部成绩和平均分
+     * @param student 学生对象
+     */
+    void insert(const Student& student);
+    
+    /**
+     * @brief 移除学生的全部成绩和平均分
+     * @param student 学生对象（须为加入时的状态）
+     */
+    void erase(const Student& student);
+    
+    /**
+     * @brief 清空
+     */
+    void clear();
+    
+    /**
+     * @brief 查询成绩在全校的排名
+     * @param subject 科目（空串表示平均分）
+     * @param score 成绩
+     * @return ScoreRank 排名，该科目无人参与时total为0
+     */
+    ScoreRank school_rank(const std::string& subject, float score) const;
+    
+    /**
+     * @brief 查询成绩在班级内的排名
+     * @param class_id 班级号
+     * @param subject 科目（空串表示平均分）
+     * @param score 成绩
+     * @return ScoreRank 排名，该班级该科目无人参与时total为0
+     */
+    ScoreRank class_rank(const std::string& class_id, const std::string& subject, float score) const;
+
+private:
+    static constexpr size_t BUCKETS = 1001;  ///< 0.0-100.0分，每0.1分一个桶
+    
+    /**
+     * @struct Counter
+     * @brief 一个(范围, 科目)的分数分布
+     */
+    struct Counter {
+        FenwickTree tree{BUCKETS};  ///< 各桶人数
+        size_t total = 0;           ///< 总人数
+    };
+    
+    using SubjectCounters = std::unordered_map<std::string, Counter>;  ///< 科目->分数分布
+    
+    SubjectCounters school_;                                   ///< 全校
+    std::unordered_map<std::string, SubjectCounters> classes_; ///< 班级号->各科分数分布
+    
+    /**
+     * @brief 将成绩换算为桶下标
+     * @param score 成绩
+     * @return size_t 桶下标
+     */
+    static size_t bucket_of(float score);
+    
+    /**
+     * @brief 在一个范围内加入或移除学生的全部成绩
+     * @param counters 范围
+     * @param student 学生对象
+     * @param delta 1为加入，-1为移除
+     */
+    static void apply(SubjectCounters& counters, const Student& student, int32_t delta);
+    
+    /**
+     * @brief 在一个范围内查询排名
+     * @param counters 范围
+     * @param subject 科目
+     * @param score 成绩
+     * @return ScoreRank 排名
+     */
+    static ScoreRank rank_in(const SubjectCounters& counters, const std::string& subject, float score);
+};
@@ -0,0 +1,89 @@
+/**
+ * @file segment_manifest.hh
+ * @brief 分段保存的清单文件
+ * 
+ * 分段保存时学生按学号范围分到若干段（学号末3位替换为x，如"2023xxx"），每段一个CSV文件，
+ * 清单文件记录各段当前对应的文件。段文件名带代号，重写的段写成新代号的文件，
+ * 清单替换完成后才删除旧文件，因此保存中途失败时旧清单及其文件仍然完整。
+ * 
+ * 清单为文本格式：首行为MAGIC，第二行为"generation,代号"，之后每段一行"段名,文件,学生数,字节数,CRC32C"，
+ * 文件路径相对清单所在目录，CRC32C为8位十六进制（较早的清单没有这一列，加载时不校验）。
+ */
+
+#pragma once
+
+#include "student_id.hh"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+
+/**
+ * @struct SegmentEntry
+ * @brief 清单中的一段
+ */
+struct SegmentEntry {
+    std::string file;      ///< 段文件（相对清单所在目录）
+    size_t count = 0;      ///< 学生数
+    uint64_t size = 0;     ///< 文件字节数
+    uint32_t crc = 0;      ///< 文件内容的CRC32C
+    bool has_crc = false;  ///< 清单中是否记录了CRC32C
+};
+
+/**
+ * @class SegmentManifest
+ * @brief 分段清单
+ */
+class SegmentManifest {
+public:
+    static constexpr const char* MAGIC = "SMS-SEGMENTS 1";  ///< 清单首行
+    static constexpr size_t SEGMENT_DIGITS = 3;            ///< 同一段内学号只有末尾这几位不同
+    
+    uint64_t generation = 0;                        ///< 代号，每次分段保存加一
+    std::map<std::string, SegmentEntry> segments;   ///< 段名->段文件（按段名排序）
+    
+    /**
+     * @brief 计算学号所属的段名
+     * @param id 数值学号
+     * @return std::string 段名，学号末SEGMENT_DIGITS位替换为'x'
+     */
+    static std::string segment_of(const StudentId& id);
+    
+    /**
+     * @brief 存放段文件的目录
+     * @param manifest 清单文件名
+     * @return std::string 目录路径（清单文件名加".seg"）
+     */
+    static std::string directory_for(const std::string& manifest);
+    
+    /**
+     * @brief 段文件的相对路径
+     * @param manifest 清单文件名
+     * @param segment 段名
+     * @param generation 代号
+     * @return std::string 相对清单所在目录的路径，如"students.manifest.seg/2023xxx.5.csv"
+     */
+    static std::string file_for(const std::string& manifest, const std::string& segment, uint64_t generation);
+    
+    /**
+     * @brief 将清单中的相对路径换算为可打开的路径
+     * @param manifest 清单文件名
+     * @param file 相对路径
+     * @return std::string 路径
+     */
+    static std::string resolve(const std::string& manifest, const std::string& file);
+    
+    /**
+     * @brief 读取清单
+     * @param filename 清单文件名
+     * @return bool 文件存在且格式正确返回true
+     */
+    bool load(const std::string& filename);
+    
+    /**
+     * @brief 写出清单（先写临时文件再替换）
+     * @param filename 清单文件名
+     * @return bool 写出成功返回true
+     */
+    bool save(const std::string& filename) const;
+};
@@ -10,11 +10,13 @@
 
 #include <string>
 #include <list>
+#include <cstdint>
 #include <unordered_map>
 #include <iostream>
 #include <regex>
 #include <stdexcept>
 #include "logger.hh"
+#include "student_id.hh"
 
 /**
  * @class Student
@@ -45,9 +47,30 @@ public:
             std::string class_id, std::string phone = "", std::string email = "");
     
     /**
-     * @brief 显示学生详细信息到控制台
+     * @brief 显示学生详细信息
+     * @param out 输出流，默认为控制台
      */
-    void show_info() const;
+    void show_info(std::ostream& out = std::cout) const;
+    
+    /**
+     * @brief 将学生详细信息追加到缓冲区（格式与show_info相同）
+     * @param buffer 输出缓冲区
+     */
+    void format_into(std::string& buffer) const;
+    
+    /**
+     * @brief 将学生信息以表格行的形式追加到缓冲区
+     * @param buffer 输出缓冲区
+     * 
+     * 列依次为学号、姓名、性别、班级、电话、科目数和平均分，与format_table_header对齐。
+     */
+    void format_row_into(std::string& buffer) const;
+    
+    /**
+     * @brief 将表格表头追加到缓冲区
+     * @param buffer 输出缓冲区
+     */
+    static void format_table_header(std::string& buffer);
     
     /**
      * @brief 设置学生成绩
@@ -64,12 +87,27 @@ public:
      */
     float get_score(const std::string& subject) const;
     
+    /**
+     * @brief 删除指定科目成绩
+     * @param subject 科目名称
+     * @return bool 科目存在并被删除返回true
+     */
+    bool remove_score(const std::string& subject);
+    
     /**
      * @brief 计算所有科目平均分
      * @return float 平均分，无成绩时返回0
+     * 
+     * 由成绩摘要直接计算，不访问成绩明细。
      */
     float get_average_score() const;
     
+    /**
+     * @brief 获取科目数
+     * @return size_t 已设置成绩的科目数
+     */
+    size_t get_score_count() const { return score_count_; }
+    
     /**
      * @brief 验证学生基本信息是否完整
      * @return bool 信息完整返回true，否则返回false
@@ -78,12 +116,27 @@ public:
      */
     bool is_valid() const;
     
+    /**
+     * @brief 比较两个学生的全部字段和成绩是否一致
+     * @param other 另一个学生对象
+     * @return bool 完全一致返回true
+     */
+    bool operator==(const Student& other) const;
+    
+    /**
+     * @brief 比较两个学生是否存在差异
+     * @param other 另一个学生对象
+     * @return bool 存在差异返回true
+     */
+    bool operator!=(const Student& other) const { return !(*this == other); }
+    
     // Getter方法
-    const std::string& get_id() const { return id_; }           ///< 获取学号
+    std::string get_id() const { return id_.to_string(); }     ///< 获取学号（由数值学号重建）
+    const StudentId& get_id_key() const { return id_; }         ///< 获取数值学号（用于比较、哈希和排序）
     const std::string& get_name() const { return name_; }       ///< 获取姓名
     const std::string& get_gender() const { return gender_; }   ///< 获取性别
     const std::string& get_class_id() const { return class_id_; } ///< 获取班级号
-    const std::string& get_phone() const { return phone_; }     ///< 获取电话
+    std::string get_phone() const;                              ///< 获取电话（由数值重建，未设置时为空）
     const std::string& get_email() const { return email_; }     ///< 获取邮箱
     const std::unordered_map<std::string, float>& get_scores() const { return scores_; } ///< 获取成绩映射表
     
@@ -96,20 +149,22 @@ public:
     void set_email(const std::string& email);   ///< 设置邮箱（带验证）
 
 private:
-    std::string id_;           ///< 学号
+    StudentId id_;             ///< 学号（数值形式）
     std::string name_;         ///< 姓名
     std::string gender_;       ///< 性别
     std::string class_id_;     ///< 班级号
-    std::string phone_;        ///< 电话
+    uint64_t phone_ = 0;       ///< 电话（11位数字以整数存放，0表示未设置）
     std::string email_;        ///< 邮箱
     std::unordered_map<std::string, float> scores_; ///< 成绩映射表（科目->成绩）
+    uint32_t score_count_ = 0; ///< 成绩摘要：科目数
+    double score_sum_ = 0.0;   ///< 成绩摘要：成绩总和
     
     // 验证方法
-    void validate_id(const std::string& id) const;         ///< 验证学号格式
+    StudentId validate_id(const std::string& id) const;    ///< 验证学号格式并转换为数值学号
     void validate_name(const std::string& name) const;     ///< 验证姓名格式
     void validate_gender(const std::string& gender) const; ///< 验证性别格式
     void validate_class_id(const std::string& class_id) const; ///< 验证班级号格式
-    void validate_phone(const std::string& phone) const;   ///< 验证电话格式
+    uint64_t validate_phone(const std::string& phone) const; ///< 验证电话格式并转换为整数
     void validate_email(const std::string& email) const;   ///< 验证邮箱格式
 };
 
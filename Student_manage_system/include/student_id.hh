@@ -0,0 +1,64 @@
+/**
+ * @file student_id.hh
+ * @brief 定长数值学号
+ * 
+ * 3-20位数字学号以两段整数加位数的形式存储，比较、哈希和排序都是整数运算，
+ * 位数用于保留前导零。需要字符串时再按需重建。
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @struct StudentId
+ * @brief 数值学号
+ * 
+ * 数值为high * 10^19 + low（20位学号超出uint64_t范围，最高位单独存放）。
+ * 排序按数值升序，数值相同时位数少的在前（如"07"在"007"之前）。
+ */
+struct StudentId {
+    uint64_t low = 0;    ///< 数值除以10^19的余数
+    uint8_t high = 0;    ///< 数值除以10^19的商（只有20位学号可能非零）
+    uint8_t length = 0;  ///< 位数，0表示未设置
+    
+    /**
+     * @brief 解析数字字符串
+     * @param text 1-20位数字字符串
+     * @param out 输出参数，解析结果
+     * @return bool 格式正确返回true
+     */
+    static bool parse(const std::string& text, StudentId& out);
+    
+    /**
+     * @brief 重建学号字符串（含前导零）
+     * @return std::string 学号字符串，未设置时为空
+     */
+    std::string to_string() const;
+    
+    bool operator==(const StudentId& other) const {
+        return low == other.low && high == other.high && length == other.length;
+    }
+    bool operator!=(const StudentId& other) const { return !(*this == other); }
+    bool operator<(const StudentId& other) const {
+        if (high != other.high) return high < other.high;
+        if (low != other.low) return low < other.low;
+        return length < other.length;
+    }
+};
+
+/**
+ * @struct StudentIdHash
+ * @brief StudentId哈希函数
+ */
+struct StudentIdHash {
+    size_t operator()(const StudentId& id) const {
+        uint64_t h = id.low ^ (static_cast<uint64_t>(id.high) << 56) ^ (static_cast<uint64_t>(id.length) << 48);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return static_cast<size_t>(h);
+    }
+};
@@ -0,0 +1,230 @@
+/**
+ * @file student_schema.hh
+ * @brief 学生基本字段的编译期描述表
+ * 
+ * 每个基本字段用一个描述类型表示：列名、读取、带验证的设置以及是否可以为空。
+ * StudentFields按文件中的列顺序列出全部描述类型，CSV和二进制编解码、控制台显示、
+ * 撤销记录都在编译期对这张表逐字段展开，不在运行时按字段分派；增减字段只需修改这里。
+ * 成绩是长度可变的映射表，不在表中，由各格式在基本字段之后单独编码。
+ * ColumnSet按同样的编号描述加载时需要解析的列。
+ */
+
+#pragma once
+
+#include "student.hh"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @enum StudentField
+ * @brief 可被修改的学生基本字段
+ */
+enum class StudentField : uint8_t {
+    ID,        ///< 学号
+    NAME,      ///< 姓名
+    GENDER,    ///< 性别
+    CLASS_ID,  ///< 班级号
+    PHONE,     ///< 电话
+    EMAIL      ///< 邮箱
+};
+
+namespace student_schema {
+
+/**
+ * @struct IdField
+ * @brief 学号
+ */
+struct IdField {
+    static constexpr StudentField KEY = StudentField::ID;  ///< 字段编号
+    static constexpr const char* LABEL = "学号";           ///< 列名
+    static constexpr bool NULLABLE = false;                ///< 是否可以为空
+    static std::string get(const Student& student) { return student.get_id(); }
+    static void set(Student& student, const std::string& value) { student.set_id(value); }
+};
+
+/**
+ * @struct NameField
+ * @brief 姓名
+ */
+struct NameField {
+    static constexpr StudentField KEY = StudentField::NAME;
+    static constexpr const char* LABEL = "姓名";
+    static constexpr bool NULLABLE = false;
+    static const std::string& get(const Student& student) { return student.get_name(); }
+    static void set(Student& student, const std::string& value) { student.set_name(value); }
+};
+
+/**
+ * @struct GenderField
+ * @brief 性别
+ */
+struct GenderField {
+    static constexpr StudentField KEY = StudentField::GENDER;
+    static constexpr const char* LABEL = "性别";
+    static constexpr bool NULLABLE = false;
+    static const std::string& get(const Student& student) { return student.get_gender(); }
+    static void set(Student& student, const std::string& value) { student.set_gender(value); }
+};
+
+/**
+ * @struct ClassIdField
+ * @brief 班级号
+ */
+struct ClassIdField {
+    static constexpr StudentField KEY = StudentField::CLASS_ID;
+    static constexpr const char* LABEL = "班级";
+    static constexpr bool NULLABLE = false;
+    static const std::string& get(const Student& student) { return student.get_class_id(); }
+    static void set(Student& student, const std::string& value) { student.set_class_id(value); }
+};
+
+/**
+ * @struct PhoneField
+ * @brief 电话
+ */
+struct PhoneField {
+    static constexpr StudentField KEY = StudentField::PHONE;
+    static constexpr const char* LABEL = "电话";
+    static constexpr bool NULLABLE = true;
+    static std::string get(const Student& student) { return student.get_phone(); }
+    static void set(Student& student, const std::string& value) { student.set_phone(value); }
+};
+
+/**
+ * @struct EmailField
+ * @brief 邮箱
+ */
+struct EmailField {
+    static constexpr StudentField KEY = StudentField::EMAIL;
+    static constexpr const char* LABEL = "邮箱";
+    static constexpr bool NULLABLE = true;
+    static const std::string& get(const Student& student) { return student.get_email(); }
+    static void set(Student& student, const std::string& value) { student.set_email(value); }
+};
+
+/**
+ * @struct FieldList
+ * @brief 字段描述类型的有序列表
+ * @tparam Fields 字段描述类型
+ */
+template<typename... Fields>
+struct FieldList {
+    static constexpr size_t SIZE = sizeof...(Fields);  ///< 字段数
+    
+    /**
+     * @brief 按顺序对每个字段调用一次action(描述类型的值)，展开为顺序调用
+     * @param action 访问函数（泛型lambda）
+     */
+    template<typename F>
+    static void for_each(F&& action) {
+        (action(Fields{}), ...);
+    }
+    
+    /**
+     * @brief 对编号为key的字段调用action，展开为一串比较
+     * @param key 字段编号
+     * @param action 访问函数（泛型lambda）
+     * @return bool 找到字段返回true
+     */
+    template<typename F>
+    static bool visit(StudentField key, F&& action) {
+        return ((Fields::KEY == key ? (action(Fields{}), true) : false) || ...);
+    }
+};
+
+/// 文件中的列顺序，成绩列跟在最后
+using StudentFields = FieldList<IdField, NameField, GenderField, ClassIdField, PhoneField, EmailField>;
+
+constexpr const char* SCORES_LABEL = "成绩信息";  ///< 成绩列的列名
+
+} // namespace student_schema
+
+/**
+ * @class ColumnSet
+ * @brief 加载时需要解析的列
+ * 
+ * 学号总是解析，其余基本字段按StudentField编号各占一位，成绩列占最后一位。
+ * 不在集合中的列在切分时直接跳过，不复制也不验证，对应字段保持为空。
+ */
+class ColumnSet {
+public:
+    /**
+     * @brief 全部列
+     * @return ColumnSet 包含全部基本字段和成绩列的集合
+     */
+    static ColumnSet all() {
+        ColumnSet columns;
+        columns.bits_ = ALL;
+        return columns;
+    }
+    
+    /**
+     * @brief 按列名解析（如"学号,班级,成绩信息"）
+     * @param labels 逗号分隔的列名，列名两侧的空格被忽略
+     * @param columns 输出参数，解析结果（学号总是包含在内）
+     * @return bool 全部列名都能识别返回true
+     */
+    static bool parse(const std::string& labels, ColumnSet& columns);
+    
+    ColumnSet& add(StudentField field) { bits_ |= bit(field); return *this; }  ///< 加入一个基本字段
+    ColumnSet& add_scores() { bits_ |= SCORES; return *this; }                 ///< 加入成绩列
+    bool has(StudentField field) const { return (bits_ & bit(field)) != 0; }   ///< 是否包含基本字段
+    bool has_scores() const { return (bits_ & SCORES) != 0; }                  ///< 是否包含成绩列
+    bool is_all() const { return bits_ == ALL; }                               ///< 是否包含全部列
+    
+    /**
+     * @brief 转换为逗号分隔的列名，按文件中的列顺序
+     * @return std::string 列名列表
+     */
+    std::string to_string() const;
+
+private:
+    /**
+     * @brief 基本字段对应的位
+     * @param field 字段
+     * @return uint32_t 位掩码
+     */
+    static constexpr uint32_t bit(StudentField field) { return 1u << static_cast<unsigned>(field); }
+    
+    static constexpr uint32_t SCORES = 1u << student_schema::StudentFields::SIZE;  ///< 成绩列对应的位
+    static constexpr uint32_t ALL = (SCORES << 1) - 1;                             ///< 全部列
+    
+    uint32_t bits_ = bit(StudentField::ID);  ///< 需要解析的列
+};
+
+/**
+ * @brief 读取学生的指定字段
+ * @param student 学生对象
+ * @param field 字段
+ * @return std::string 字段值
+ */
+std::string get_student_field(const Student& student, StudentField field);
+
+/**
+ * @brief 设置学生的指定字段（带验证）
+ * @param student 学生对象
+ * @param field 字段
+ * @param value 新值
+ * @throws std::invalid_argument 当字段验证失败
+ */
+void set_student_field(Student& student, StudentField field, const std::string& value);
+
+/**
+ * @brief 将学生对象编码为二进制记录并追加到缓冲区
+ * @param out 输出缓冲区
+ * @param student 学生对象
+ * 
+ * 各字段依次写为带长度前缀的字符串，之后是科目数和各科的（科目, 成绩），采用本机字节序。
+ */
+void append_student_binary(std::string& out, const Student& student);
+
+/**
+ * @brief 从二进制记录解码学生对象
+ * @param data 记录起始地址
+ * @param size 记录长度
+ * @param student 输出参数，解码得到的学生对象
+ * @return bool 记录完整返回true，截断或有多余数据返回false
+ * @throws std::invalid_argument 当字段验证失败
+ */
+bool student_from_binary(const char* data, size_t size, Student& student);
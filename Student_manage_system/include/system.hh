@@ -9,11 +9,112 @@
 #pragma once
 
 #include "student.hh"
+#include "student_schema.hh"
 #include "logger.hh"
+#include "change_stream.hh"
+#include "undo_history.hh"
+#include "transaction.hh"
+#include "prefix_index.hh"
+#include "name_search.hh"
+#include "bloom_filter.hh"
+#include "frozen_roster.hh"
+#include "index_file.hh"
+#include "flat_id_map.hh"
+#include "score_rank.hh"
+#include "segment_manifest.hh"
+#include "log_store.hh"
+#include "page_index.hh"
+#include <array>
 #include <list>
+#include <memory>
+#include <mutex>
+#include <set>
 #include <string>
 #include <fstream>
 #include <algorithm>
+#include <unordered_map>
+#include <shared_mutex>
+
+/**
+ * @struct ImportStats
+ * @brief 增量导入统计信息
+ * 
+ * 记录upsert导入过程中每一行数据的处理结果。
+ */
+struct ImportStats {
+    size_t inserted = 0;   ///< 新增的学生数
+    size_t updated = 0;    ///< 字段或成绩发生变化的学生数
+    size_t unchanged = 0;  ///< 内容与现有记录一致的学生数
+    size_t deleted = 0;    ///< 按删除标记删除的学生数
+    size_t not_found = 0;  ///< 删除标记指向不存在学号的行数
+    size_t invalid = 0;    ///< 格式错误或验证失败的行数
+};
+
+/**
+ * @struct LoadIssue
+ * @brief 多文件加载中被跳过的一行或无法读取的一个文件
+ */
+struct LoadIssue {
+    std::string filename;  ///< 文件名
+    size_t line = 0;       ///< 行号（从1开始，0表示整个文件）
+    std::string message;   ///< 问题说明
+};
+
+/**
+ * @struct LoadReport
+ * @brief 多文件加载的汇总报告
+ */
+struct LoadReport {
+    size_t files_loaded = 0;        ///< 成功读取的文件数
+    size_t files_failed = 0;        ///< 无法打开或校验失败的文件数
+    size_t loaded = 0;              ///< 加载的学生数
+    size_t invalid = 0;             ///< 格式错误或验证失败的行数
+    size_t duplicates = 0;          ///< 因学号重复被跳过的行数（含跨文件重复）
+    std::vector<LoadIssue> issues;  ///< 全部问题，按文件在列表中的顺序和行号排列
+};
+
+/**
+ * @struct NameMatch
+ * @brief 姓名近似搜索结果
+ */
+struct NameMatch {
+    std::string student_id;  ///< 学号
+    std::string name;        ///< 姓名
+    int distance = 0;        ///< 与查询串的编辑距离
+};
+
+/**
+ * @enum SortField
+ * @brief 多键排序的字段
+ */
+enum class SortField {
+    ID,             ///< 学号
+    NAME,           ///< 姓名
+    CLASS_ID,       ///< 班级号
+    AVERAGE_SCORE,  ///< 平均分（没有成绩的学生排在最后）
+    SUBJECT_SCORE   ///< 某科成绩（没有该科成绩的学生排在最后）
+};
+
+/**
+ * @struct SortKey
+ * @brief 多键排序的一个排序键
+ */
+struct SortKey {
+    SortField field = SortField::ID;  ///< 排序字段
+    std::string subject;              ///< 科目（仅SUBJECT_SCORE使用）
+    bool descending = false;          ///< 是否降序
+};
+
+/**
+ * @struct StudentPage
+ * @brief 分页列表的一页
+ */
+struct StudentPage {
+    std::vector<Student> students;  ///< 本页学生（数据副本）
+    size_t total = 0;               ///< 查询时的学生总数
+    size_t remaining = 0;           ///< 本页之后还剩余的学生数
+    std::string next_token;         ///< 下一页的续页令牌，已是最后一页时为空
+};
 
 /**
  * @class StudentManagementSystem
@@ -21,6 +122,9 @@
  * 
  * 负责学生信息的完整生命周期管理，包括增删改查操作和文件存储。
  * 使用STL链表存储学生数据，提供完整的操作接口和错误处理。
+ * 
+ * 公共接口由读写锁保护，可被多个线程并发调用；查询接口返回学生数据的副本，
+ * 或在共享锁内调用访问函数，不把名册中对象的指针或引用交给调用方。
  */
 class StudentManagementSystem {
 public:
@@ -62,24 +166,51 @@ public:
     /**
      * @brief 根据学号查询学生
      * @param student_id 要查询的学生学号
-     * @return Student* 找到返回学生指针，否则返回nullptr
+     * @param student 输出参数，找到时写入学生数据的副本
+     * @return bool 找到返回true
+     */
+    bool find_student_by_id(const std::string& student_id, Student& student);
+    
+    /**
+     * @brief 判断学号是否存在
+     * @param student_id 学号
+     * @return bool 存在返回true
+     */
+    bool has_student(const std::string& student_id);
+    
+    /**
+     * @brief 批量根据学号查询学生
+     * @param student_ids 学号列表
+     * @param visit 对每个找到的学生调用，参数为学号在student_ids中的下标和学生
+     * @return size_t 找到的学生数，不存在或格式错误的学号不调用visit
+     * 
+     * 先计算全部学号的哈希值，查找时提前预取后面学号的槽位和学生记录，
+     * 使多次缓存未命中的等待相互重叠；学生数据远大于缓存时吞吐量明显高于逐个调用。
+     * visit在共享锁内调用，不复制学生对象，不能在其中调用本对象的修改操作。
      */
-    Student* find_student_by_id(const std::string& student_id);
+    size_t find_students_by_ids(const std::vector<std::string>& student_ids,
+                                const std::function<void(size_t index, const Student& student)>& visit);
     
     /**
      * @brief 根据姓名查询学生（支持模糊查询）
      * @param name 要查询的学生姓名
-     * @return std::list<Student*> 找到的学生指针列表
+     * @return std::vector<Student> 找到的学生副本
      * 
      * 使用字符串包含匹配进行模糊查询，返回所有匹配的学生。
      */
-    std::list<Student*> find_students_by_name(const std::string& name);
+    std::vector<Student> find_students_by_name(const std::string& name);
     
     /**
      * @brief 获取所有学生
-     * @return const std::list<Student>& 学生列表常量引用
+     * @return StudentList 学生列表的副本
      */
-    const std::list<Student>& get_all_students() const;
+    StudentList get_all_students() const;
+    
+    /**
+     * @brief 按名册顺序遍历所有学生
+     * @param visit 对每个学生调用（在共享锁内调用，不能在其中调用本对象的修改操作）
+     */
+    void for_each_student(const std::function<void(const Student& student)>& visit) const;
     
     /**
      * @brief 获取学生数量
@@ -87,6 +218,12 @@ public:
      */
     size_t get_student_count() const;
     
+    /**
+     * @brief 获取学号布隆过滤器的统计数据
+     * @return BloomFilterStats 查询次数、直接排除次数和假阳性次数
+     */
+    BloomFilterStats id_filter_stats() const;
+    
     /**
      * @brief 清空所有学生数据
      */
@@ -97,34 +234,210 @@ public:
      * @param filename 文件名
      * @return bool 保存成功返回true，失败返回false
      * 
-     * 将学生数据和成绩信息保存为CSV格式文件。
+     * 将学生数据和成绩信息保存为CSV格式文件，并在旁边写入索引文件（文件名加".idx"），
+     * 下次加载同一文件时直接恢复索引；同时写入分块校验文件（文件名加".crc"）。
+     * 名册只加载了部分列时拒绝保存，以免覆盖掉文件中未加载的列。
      */
     bool save_to_file(const std::string& filename);
     
+    /**
+     * @brief 分段增量保存
+     * @param filename 清单文件名，段文件写在旁边的"清单文件名.seg"目录中
+     * @param rewritten 输出参数，本次重写或删除的段数
+     * @return bool 保存成功返回true
+     * 
+     * 学生按学号范围分段（见SegmentManifest），只重写自上次分段保存或加载以来有学生被修改的段；
+     * 保存到与上次不同的清单、或上次之后整体重新加载过时重写全部段。
+     * 用load_from_file加载清单文件即可读回全部段，加载后学生按段名顺序排列。
+     * 名册只加载了部分列时拒绝保存。
+     */
+    bool save_segments(const std::string& filename, size_t& rewritten);
+    
+    /**
+     * @brief 打开日志结构存储，之后每次修改都追加写入其中
+     * @param directory 存储目录，不存在时创建
+     * @return bool 打开成功返回true
+     * 
+     * 存储中已有学生时以存储为准重新加载名册（与load_from_file相同，会清空现有数据和撤销历史）；
+     * 存储为空时写入当前名册作为初始内容（名册只加载了部分列时拒绝打开）。
+     * 存储在后台自动整理，不必再调用save_to_file。
+     */
+    bool open_log_store(const std::string& directory);
+    
+    /**
+     * @brief 关闭日志结构存储，名册保留在内存中
+     */
+    void close_log_store();
+    
+    /**
+     * @brief 获取日志结构存储的状态
+     * @return LogStoreStats 段数、有效与失效字节数和整理次数
+     */
+    LogStoreStats log_store_stats() const;
+    
     /**
      * @brief 从文件加载数据（包含成绩信息）
      * @param filename 文件名
+     * @param columns 需要加载的列，默认全部
      * @return bool 加载成功返回true，失败返回false
      * 
      * 从CSV格式文件加载学生数据和成绩信息，自动验证数据有效性。
+     * 存在与数据文件一致的索引文件时从中恢复二级索引，否则重新构建。
+     * 文件是分段清单（见save_segments）时加载清单中的全部段。
+     * 存在未过期的校验文件（见BlockChecksums）时先按块并行校验，发现损坏则不加载、保留现有数据。
+     * 
+     * 只加载部分列时，其余列在切分时跳过、不做验证，对应字段为空（如只需要学号、班级和成绩的统计）；
+     * 这样的名册不能保存回数据文件，也不能导出，直到重新加载全部列。日志结构存储或变更日志打开期间不能只加载部分列
+     * （未加载的必填字段为空，写出的记录无法被重放）。
+     */
+    bool load_from_file(const std::string& filename, const ColumnSet& columns = ColumnSet::all());
+    
+    /**
+     * @brief 从多个文件并发加载数据，合并为一份名册
+     * @param filenames 文件名列表
+     * @param report 输出参数，汇总报告
+     * @param threads 解析文件的线程数，0表示按硬件并发数
+     * @param columns 需要加载的列，默认全部（见load_from_file）
+     * @return bool 至少加载了一名学生返回true
+     * 
+     * 与load_from_file一样先清空现有数据。各文件在线程池中并发解析，
+     * 学号通过共享的并发集合查重；重复学号保留列表中靠前文件（同一文件内靠前行）的记录，
+     * 结果与按顺序逐个加载相同。解析期间不持有写锁。校验失败的文件整体跳过，计入files_failed。
+     */
+    bool load_from_files(const std::vector<std::string>& filenames, LoadReport& report, size_t threads = 0,
+                         const ColumnSet& columns = ColumnSet::all());
+    
+    /**
+     * @brief 获取当前名册加载了哪些列
+     * @return ColumnSet 上次整体加载时指定的列，添加、清空等操作不改变；未加载过时为全部列
+     */
+    ColumnSet loaded_columns() const;
+    
+    /**
+     * @brief 增量导入（upsert模式）
+     * @param filename 增量CSV文件名
+     * @param stats 输出参数，逐行处理结果统计
+     * @return bool 文件可读返回true，否则返回false
+     * 
+     * 不清空现有数据，将文件合并到当前存储：新学号插入，已有学号的字段和成绩被替换。
+     * 学号列以'-'开头的行视为删除标记（如"-2023001"），删除对应学生。
+     * 耗时与增量文件行数成正比。
+     */
+    bool upsert_from_file(const std::string& filename, ImportStats& stats);
+    
+    /**
+     * @brief 撤销最近一次操作
+     * @return bool 撤销成功返回true，没有可撤销的操作返回false
+     * 
+     * 单次增删改和设置成绩作为一次操作撤销；一次增量导入作为一个批次整体撤销。
+     * 加载文件或清空数据会清空撤销历史。
+     */
+    bool undo();
+    
+    /**
+     * @brief 重做最近一次被撤销的操作
+     * @return bool 重做成功返回true，没有可重做的操作返回false
+     */
+    bool redo();
+    
+    /**
+     * @brief 开始事务
+     * @return Transaction 空事务，操作记录在事务内部直到提交
+     */
+    Transaction begin_transaction() const;
+    
+    /**
+     * @brief 提交事务
+     * @param txn 要提交的事务
+     * @return bool 全部操作校验通过并生效返回true；任一操作失败则不做任何修改并返回false
+     * 
+     * 在写锁下基于当前数据依次校验事务内的操作，得到最终写集合后一次性应用，
+     * 每个受影响学生的索引只更新一次。并发读者只能看到提交前或提交后的完整状态。
+     * 一次提交作为一个撤销批次。无论成功与否，事务都将结束。
+     */
+    bool commit(Transaction& txn);
+    
+    /**
+     * @brief 回滚事务，丢弃事务内的全部操作
+     * @param txn 要回滚的事务
      */
-    bool load_from_file(const std::string& filename);
+    void rollback(Transaction& txn);
     
     /**
      * @brief 保存数据到Excel格式文件（包含成绩信息）
      * @param filename 文件名
      * @return bool 保存成功返回true，失败返回false
      * 
-     * 按照学号从小到大排序后保存为CSV格式（Excel兼容），包含成绩信息。
+     * 按指定顺序保存为CSV格式（Excel兼容），包含成绩信息；不改变内存中的学生顺序。
+     * 与save_to_file一样在旁边写入索引文件（文件名加".idx"）和分块校验文件（文件名加".crc"），
+     * 菜单保存后下次启动加载时直接恢复索引。
+     * 名册只加载了部分列时拒绝保存，以免导出的文件中未加载的列为空。
      */
-    bool save_to_excel_file(const std::string& filename);
+    bool save_to_excel_file(const std::string& filename, const std::vector<SortKey>& order = {});
+    
+    /**
+     * @brief 按班级拆分导出，每个班级一个CSV文件
+     * @param output_dir 输出目录（不存在时自动创建）
+     * @param class_count 输出参数，成功写出的班级文件数
+     * @param threads 写文件的线程数，0表示按硬件并发数
+     * @return bool 全部班级文件写出成功返回true
+     * 
+     * 一次遍历按班级分组，再由线程池并发写出各班级文件（<班级号>.csv，
+     * 文件名中不可用的字符替换为'_'，替换后重名的按班级首次出现的顺序加_2、_3）。
+     * 每个文件先在内存中整体编码，再一次写出。
+     * 文件格式与save_to_excel_file相同，班级内保持名册中的顺序；名册只加载了部分列时拒绝导出。
+     */
+    bool export_by_class(const std::string& output_dir, size_t& class_count, size_t threads = 0);
+    
+    /**
+     * @brief 按多个排序键排序
+     * @param keys 排序键，依次比较；为空时按学号升序
+     * @return std::vector<Student> 排序后的学生副本
+     * 
+     * 对下标排列做并行稳定归并排序，不移动学生对象，排好后再复制；所有键都相同的学生保持原有顺序。
+     */
+    std::vector<Student> sort_by(const std::vector<SortKey>& keys) const;
+    
+    /**
+     * @brief 解析排序说明
+     * @param spec 以逗号分隔的排序键，如"班级,平均分降序,数学降序"；
+     *             字段为学号、姓名、班级、平均分或科目名，后缀"降序"/"升序"（默认升序）
+     * @param keys 输出参数，解析结果
+     * @return bool 格式正确返回true
+     */
+    static bool parse_sort_keys(const std::string& spec, std::vector<SortKey>& keys);
     
     /**
      * @brief 显示所有学生信息
+     * @param compact true表示每名学生一行的表格形式，false表示详细信息
+     * 
+     * 在控制台格式化显示所有学生的信息，输出先渲染到缓冲区再分块写出。
+     */
+    void show_all_students(bool compact = false) const;
+    
+    /**
+     * @brief 分页列出学生
+     * @param page_size 每页学生数
+     * @param key 排序键
+     * @param resume_token 上一页返回的next_token，为空时从第一页开始
+     * @return StudentPage 一页学生
+     * @throws std::invalid_argument 当page_size为0或令牌无效（或与排序键不符）
      * 
-     * 在控制台格式化显示所有学生的详细信息。
+     * 令牌记录上一页最后一名学生的排序值和学号，翻页期间增删学生不会导致重复或遗漏已有学生。
+     * 每种排序键第一次分页时建立有序索引，之后随增删改维护；每页从令牌位置在索引中定位，
+     * 耗时为O(page_size + log N)，与已翻过的页数无关。
+     */
+    StudentPage list_students(size_t page_size, StudentSortKey key = StudentSortKey::ID,
+                              const std::string& resume_token = "") const;
+    
+    /**
+     * @brief 将一页学生渲染为文本
+     * @param page 分页结果
+     * @param first_index 本页第一名学生的序号（从1开始）
+     * @param compact true表示每名学生一行的表格形式，false表示详细信息
+     * @return std::string 可一次性写出的文本
      */
-    void show_all_students() const;
+    static std::string render_page(const StudentPage& page, size_t first_index = 1, bool compact = false);
 
     /**
      * @brief 按姓名删除学生（处理重名情况）
@@ -138,11 +451,11 @@ public:
     /**
      * @brief 按姓名查找学生（处理重名情况）
      * @param name 要查找的学生姓名
-     * @return std::list<Student*> 找到的学生指针列表
+     * @return std::vector<Student> 找到的学生副本
      * 
      * 支持精确匹配，显示所有匹配的学生信息。
      */
-    std::list<Student*> find_students_by_name_exact(const std::string& name);
+    std::vector<Student> find_students_by_name_exact(const std::string& name);
     
     /**
      * @brief 按学号排序学生列表
@@ -164,8 +477,351 @@ public:
      * @return std::string 格式化的成绩信息字符串
      */
     std::string get_student_scores_info(const std::string& student_id);
+    
+    /**
+     * @brief 查询学生某科成绩（或平均分）在班级和全校的排名
+     * @param student_id 学生学号
+     * @param subject 科目，空串表示平均分
+     * @param class_rank 输出参数，班级内排名
+     * @param school_rank 输出参数，全校排名
+     * @return bool 学生存在且有该科成绩（平均分要求至少一科成绩）返回true
+     * 
+     * 排名由成绩排名索引直接给出，耗时与学生人数无关。成绩按0.1分精度比较，同分同名次。
+     */
+    bool rank_of(const std::string& student_id, const std::string& subject,
+                 ScoreRank& class_rank, ScoreRank& school_rank);
+    
+    /**
+     * @brief 学号前缀补全
+     * @param prefix 学号前缀
+     * @param limit 最多返回的结果数
+     * @return std::vector<std::string> 以prefix开头的学号，按字典序排列
+     */
+    std::vector<std::string> complete_student_id(const std::string& prefix, size_t limit = 10) const;
+    
+    /**
+     * @brief 姓名前缀补全
+     * @param prefix 姓名前缀
+     * @param limit 最多返回的结果数
+     * @return std::vector<std::string> 以prefix开头的不同姓名，按字典序排列
+     */
+    std::vector<std::string> complete_student_name(const std::string& prefix, size_t limit = 10) const;
+    
+    /**
+     * @brief 学号"您是不是要找"提示
+     * @param input 用户输入的（可能不存在的）学号
+     * @param limit 最多返回的结果数
+     * @return std::vector<std::string> 与输入共享最长前缀的学号
+     */
+    std::vector<std::string> suggest_student_ids(const std::string& input, size_t limit = 5) const;
+    
+    /**
+     * @brief 姓名"您是不是要找"提示
+     * @param input 用户输入的（可能不存在的）姓名
+     * @param limit 最多返回的结果数
+     * @return std::vector<std::string> 与输入共享最长前缀的姓名
+     */
+    std::vector<std::string> suggest_student_names(const std::string& input, size_t limit = 5) const;
+    
+    /**
+     * @brief 按拼音或容错方式搜索学生姓名
+     * @param query 查询串：全拼（如zhangsan）、首字母（如zs）或含错别字/同音字的姓名
+     * @param limit 最多返回的学生数
+     * @param max_distance 最大编辑距离
+     * @return std::vector<NameMatch> 按距离、姓名、学号排序的匹配学生
+     * 
+     * 与find_students_by_name的包含匹配互补，单次查询访问的索引节点数有上限。
+     */
+    std::vector<NameMatch> search_students_by_name(const std::string& query, size_t limit = 10,
+                                                   int max_distance = 2) const;
+    
+    /**
+     * @brief 从文件补充姓名搜索使用的拼音表
+     * @param filename 文件名，每行格式为"字,拼音"
+     * @return bool 读取到至少一个条目返回true
+     */
+    bool load_pinyin_table(const std::string& filename);
+    
+    /**
+     * @brief 冻结名册：写出只读名册文件并切换为只读模式
+     * @param filename 冻结名册文件名，其他进程可通过FrozenRoster::open共享
+     * @return bool 冻结成功返回true
+     * 
+     * 冻结期间按学号查询由最小完美哈希一次探测完成，所有修改操作被拒绝，直到调用unfreeze。
+     */
+    bool freeze(const std::string& filename);
+    
+    /**
+     * @brief 解除冻结，恢复可写
+     */
+    void unfreeze();
+    
+    /**
+     * @brief 名册是否处于冻结状态
+     * @return bool 冻结返回true
+     */
+    bool is_frozen() const;
+    
+    /**
+     * @brief 获取变更流
+     * @return ChangeStream& 变更流引用
+     * 
+     * 下游可通过subscribe注册回调、通过read_since轮询环形缓冲区，
+     * 或通过open_log将变更事件追加写入文件，从而增量镜像学生数据。
+     * 没有消费者时修改不构造事件；整体加载在CLEAR之后以一个SNAPSHOT标记发布（见ChangeStream::publish_snapshot）。
+     */
+    ChangeStream& change_stream();
+    
+    /**
+     * @brief 设置系统日志级别
+     * @param level 新的日志级别
+     * 
+     * 批量重放（如只读副本）时可提高级别以避免逐条INFO日志。
+     */
+    void set_log_level(LogLevel level);
+    
+    /**
+     * @brief 设置加载和保存大文件时是否使用直接I/O（O_DIRECT）
+     * @param enabled true为使用
+     * 
+     * 加载、增量导入、保存和按班级导出都按此设置打开文件。
+     * 直接I/O绕过页缓存，每个文件前64MB仍经页缓存读写，之后的部分才直接读写，
+     * 避免一次性读写大名册时挤占缓存；文件系统不支持时保持普通读写。默认关闭，
+     * 可用命令行参数--direct-io开启。
+     */
+    void set_direct_io(bool enabled);
 
 private:
+    using StudentIter = std::list<Student>::iterator;
+
+    mutable std::shared_mutex mutex_; ///< 读写锁（公共接口加锁，私有辅助函数假定已持有锁）
     std::list<Student> students_;  ///< 学生列表（使用STL链表存储）
+    FlatIdMap<StudentIter> id_index_; ///< 学号索引（数值学号->链表迭代器）
     Logger logger_;                ///< 日志记录器实例
+    ChangeStream changes_;         ///< 变更流
+    UndoHistory history_;          ///< 撤销/重做历史
+    PrefixIndex id_prefix_;        ///< 学号前缀索引
+    PrefixIndex name_prefix_;      ///< 姓名前缀索引
+    NameSearchIndex name_search_;  ///< 姓名拼音/容错索引
+    std::unordered_map<std::string, std::set<StudentId>> name_ids_; ///< 姓名->学号（有序）
+    BloomFilter id_filter_;        ///< 学号布隆过滤器（查学号索引前快速排除不存在的学号）
+    ScoreRankIndex score_ranks_;   ///< 全校和各班级的成绩排名索引
+    std::unique_ptr<FrozenRoster> frozen_;    ///< 冻结名册（为空表示可写）
+    std::vector<StudentIter> frozen_slots_;   ///< 冻结名册槽位->链表迭代器
+    bool suppress_history_ = false; ///< 为true时不记录撤销历史（撤销/重做和整体加载期间）
+    bool bulk_load_ = false;        ///< 为true时插入记录不逐条发布变更事件（整体加载期间，完成后统一发布）
+    bool defer_indexes_ = false;    ///< 为true时插入记录只维护学号索引（从索引文件加载期间）
+    bool direct_io_ = false;        ///< 加载和保存大文件时是否使用直接I/O
+    SegmentManifest segments_;              ///< 上次分段保存或加载的清单
+    std::string segment_manifest_;          ///< segments_对应的清单文件名（为空表示没有）
+    std::set<std::string> dirty_segments_;  ///< 自上次分段保存或加载以来有学生被修改的段
+    bool segments_all_dirty_ = true;        ///< 为true时下次分段保存重写全部段
+    LogStore log_store_;                    ///< 日志结构存储（未打开时不写入）
+    bool replaying_log_ = false;            ///< 为true时修改不写入日志结构存储（从中加载期间）
+    ColumnSet loaded_columns_ = ColumnSet::all();  ///< 当前名册加载了哪些列（不是全部列时不能保存回数据文件）
+    mutable std::array<std::unique_ptr<PageIndex>, 4> page_indexes_;  ///< 各排序键的分页索引（首次分页时建立）
+    mutable std::mutex page_indexes_mutex_;  ///< 持有共享锁的读者之间保护分页索引的建立
+    
+    /**
+     * @brief 记录学生已被修改：标记所在的段，并把最新版本（或删除标记）写入日志结构存储
+     * @param key 数值学号（修改完成后调用，学生不存在表示已删除）
+     */
+    void record_changed(const StudentId& key);
+    
+    /**
+     * @brief 加载分段清单中的全部段（调用方已持有写锁）
+     * @param filename 清单文件名
+     * @param columns 需要加载的列
+     * @return bool 至少加载了一名学生返回true
+     */
+    bool load_segments(const std::string& filename, const ColumnSet& columns);
+    
+    /**
+     * @brief 将学生加入二级索引（学号索引之外的全部索引）
+     * @param student 学生对象
+     */
+    void add_to_indexes(const Student& student);
+    
+    /**
+     * @brief 将学生移出二级索引
+     * @param student 学生对象（须为加入索引时的状态）
+     */
+    void remove_from_indexes(const Student& student);
+    
+    /**
+     * @brief 插入学生记录并维护索引、发布ADD事件
+     * @param student 已验证的学生对象（学号不得重复）
+     */
+    void insert_record(Student student);
+    
+    /**
+     * @brief 删除学生记录并维护索引、发布DELETE事件
+     * @param it 要删除的学生迭代器
+     */
+    void erase_record(StudentIter it);
+    
+    /**
+     * @brief 从存储中取出学生记录（维护索引、发布DELETE事件，不记录历史）
+     * @param it 要取出的学生迭代器
+     * @return Student 被取出的学生对象
+     */
+    Student detach_record(StudentIter it);
+    
+    /**
+     * @brief 替换学生记录并维护索引、发布UPDATE事件
+     * @param it 要替换的学生迭代器
+     * @param student 新的学生对象（学号变更时新学号不得重复）
+     */
+    void replace_record(StudentIter it, Student student);
+    
+    /**
+     * @brief 设置学生成绩并发布SCORE_SET事件
+     * @param it 学生迭代器
+     * @param subject 科目名称
+     * @param score 成绩
+     * @throws std::invalid_argument 当科目名为空或成绩不在0-100范围内
+     */
+    void set_record_score(StudentIter it, const std::string& subject, float score);
+    
+    /**
+     * @brief 清空全部学生记录并发布CLEAR事件
+     */
+    void clear_records();
+    
+    /**
+     * @brief 撤销单条历史记录
+     * @param record 历史记录，撤销时被取出的学生暂存于其中
+     */
+    void revert_record(UndoRecord& record);
+    
+    /**
+     * @brief 重做单条历史记录
+     * @param record 历史记录
+     */
+    void reapply_record(UndoRecord& record);
+    
+    /**
+     * @brief 按字段和成绩增量原地修改学生并发布事件
+     * @param record UPDATE或SCORE类型的历史记录
+     * @param to_old true表示恢复为修改前的值，false表示恢复为修改后的值
+     */
+    void apply_deltas(const UndoRecord& record, bool to_old);
+    
+    /**
+     * @brief 通过学号索引查找学生
+     * @param student_id 学号
+     * @return StudentIter 找到返回对应迭代器，否则返回students_.end()
+     */
+    StudentIter find_iter(const std::string& student_id);
+    
+    /**
+     * @brief 通过数值学号查找学生（先查布隆过滤器）
+     * @param key 数值学号
+     * @return StudentIter 找到返回对应迭代器，否则返回students_.end()
+     */
+    StudentIter find_iter(const StudentId& key);
+    
+    /**
+     * @brief 判断学号是否存在（先查布隆过滤器）
+     * @param key 数值学号
+     * @return bool 存在返回true
+     */
+    bool contains_id(const StudentId& key) const;
+    
+    /**
+     * @brief 检查名册是否可写，冻结时记录警告
+     * @param operation 操作名称（用于日志）
+     * @return bool 可写返回true
+     */
+    bool check_writable(const std::string& operation);
+    
+    /**
+     * @brief 检查名册是否加载了全部列，只加载部分列时记录警告
+     * @param operation 操作名称（用于日志）
+     * @return bool 加载了全部列返回true
+     */
+    bool check_all_columns(const std::string& operation);
+    
+    /**
+     * @brief 检查能否按指定的列整体加载，日志结构存储或变更日志打开时不能只加载部分列
+     * @param columns 需要加载的列
+     * @return bool 可以加载返回true
+     */
+    bool check_load_columns(const ColumnSet& columns);
+    
+    /**
+     * @brief 按当前学号集合重建布隆过滤器（容量为学生数的两倍，至少1024）
+     */
+    void rebuild_id_filter();
+    
+    /**
+     * @brief 按当前学生列表重建全部二级索引
+     */
+    void rebuild_indexes();
+    
+    /**
+     * @brief 取得排序键的分页索引，尚未建立时按当前名册建立（须持有锁）
+     * @param key 排序键
+     * @return const PageIndex& 分页索引
+     */
+    const PageIndex& page_index(StudentSortKey key) const;
+    
+    /**
+     * @brief 从索引文件恢复二级索引
+     * @param index 已打开的索引文件
+     * @param filename 数据文件名（用于校验索引是否过期）
+     * @return bool 索引与数据文件一致且全部恢复返回true
+     */
+    bool restore_indexes(const IndexFile& index, const std::string& filename);
+    
+    /**
+     * @brief 将二级索引写入数据文件旁的索引文件
+     * @param filename 数据文件名
+     * @return bool 写入成功返回true
+     */
+    bool save_index_file(const std::string& filename) const;
+    
+    /**
+     * @brief 按给定顺序将学生写成CSV数据文件，并在旁边写入分块校验文件
+     * @param filename 数据文件名
+     * @param records 按输出顺序排列的学生
+     * @return bool 数据文件写入成功返回true（校验文件写入失败只记录警告）
+     */
+    bool write_data_file(const std::string& filename, const std::vector<const Student*>& records) const;
+    
+    /**
+     * @brief 按数据文件旁的校验文件并行校验数据文件
+     * @param filename 数据文件名
+     * @return bool 校验通过、没有校验文件或校验文件已过期返回true，发现损坏返回false
+     */
+    bool verify_data_file(const std::string& filename);
+    
+    /**
+     * @brief 按学号排序学生列表（调用方持有写锁）
+     */
+    void sort_records_by_id();
+    
+    /**
+     * @brief 按多个排序键排序（调用方持有锁）
+     * @param keys 排序键，为空时按学号升序
+     * @return std::vector<const Student*> 排序后的学生指针
+     */
+    std::vector<const Student*> sorted_records(const std::vector<SortKey>& keys) const;
+    
+    /**
+     * @brief 解析一行CSV学生数据（包含成绩信息）
+     * @param line CSV行
+     * @param student 输出参数，解析得到的学生对象
+     * @param columns 需要解析的列
+     * @return bool 列数正确返回true，格式错误返回false
+     * @throws std::invalid_argument 当字段验证失败
+     */
+    bool parse_csv_line(const std::string& line, Student& student, const ColumnSet& columns = ColumnSet::all()) const;
+    
+    /**
+     * @brief 判断首行是否为Excel表头（包含"学号"等字段），是则记录日志
+     * @param line 文件的第一行
+     * @return bool 是表头返回true
+     */
+    bool is_csv_header(const std::string& line) const;
 };
\ No newline at end of file
@@ -0,0 +1,76 @@
+/**
+ * @file thread_pool.hh
+ * @brief 固定大小的线程池
+ * 
+ * 工作线程在构造时创建，从共享任务队列中取任务执行；
+ * submit返回std::future，调用方可等待结果或取得任务抛出的异常。
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief 固定大小的线程池
+ * 
+ * 析构时先执行完队列中已提交的任务，再结束工作线程。
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief 构造函数，创建工作线程
+     * @param threads 线程数，0表示按硬件并发数
+     */
+    explicit ThreadPool(size_t threads = 0);
+    
+    /**
+     * @brief 析构函数，执行完剩余任务后结束工作线程
+     */
+    ~ThreadPool();
+    
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    /**
+     * @brief 提交任务
+     * @tparam F 任务类型，无参数可调用对象
+     * @param task 任务
+     * @return std::future 任务的返回值
+     */
+    template<typename F>
+    auto submit(F task) -> std::future<std::invoke_result_t<F>> {
+        using Result = std::invoke_result_t<F>;
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::move(task));
+        std::future<Result> result = packaged->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.emplace([packaged]() { (*packaged)(); });
+        }
+        ready_.notify_one();
+        return result;
+    }
+    
+    size_t size() const { return workers_.size(); }  ///< 工作线程数
+
+private:
+    std::vector<std::thread> workers_;         ///< 工作线程
+    std::queue<std::function<void()>> tasks_;  ///< 待执行任务
+    std::mutex mutex_;                         ///< 保护任务队列
+    std::condition_variable ready_;            ///< 有新任务或正在停止
+    bool stopping_ = false;                    ///< 是否正在停止
+    
+    /**
+     * @brief 工作线程主循环
+     */
+    void worker_loop();
+};
@@ -0,0 +1,118 @@
+/**
+ * @file transaction.hh
+ * @brief 多操作事务
+ * 
+ * 事务在私有缓冲区中记录一组操作，提交时由StudentManagementSystem一次性校验并应用，
+ * 要么全部生效，要么全部不生效。
+ */
+
+#pragma once
+
+#include "student.hh"
+#include <string>
+#include <vector>
+
+/**
+ * @enum TransactionOpType
+ * @brief 事务内操作类型
+ */
+enum class TransactionOpType {
+    ADD,        ///< 添加学生
+    UPDATE,     ///< 整体替换学生信息
+    DELETE,     ///< 删除学生
+    SET_SCORE,  ///< 设置单科成绩
+    SET_CLASS   ///< 调整班级
+};
+
+/**
+ * @struct TransactionOp
+ * @brief 事务内的单个操作
+ */
+struct TransactionOp {
+    TransactionOpType type = TransactionOpType::ADD; ///< 操作类型
+    std::string student_id;   ///< 目标学号（ADD时为新学生学号）
+    Student student;          ///< ADD/UPDATE时的学生对象
+    std::string value;        ///< SET_SCORE时为科目，SET_CLASS时为新班级号
+    float score = 0.0f;       ///< SET_SCORE时的成绩
+};
+
+/**
+ * @class Transaction
+ * @brief 事务写集合
+ * 
+ * 通过StudentManagementSystem::begin_transaction创建。操作只记录在事务内部，
+ * 在commit之前对其他读者不可见；后续操作可以看到同一事务中先前操作的结果。
+ * 事务只能移动不能复制，同一组操作不会被提交两次。
+ */
+class Transaction {
+public:
+    Transaction(const Transaction&) = delete;
+    Transaction& operator=(const Transaction&) = delete;
+    
+    /**
+     * @brief 移动构造函数，被移走的事务不再可提交
+     * @param other 源事务
+     */
+    Transaction(Transaction&& other) noexcept;
+    
+    /**
+     * @brief 移动赋值，被移走的事务不再可提交
+     * @param other 源事务
+     * @return Transaction& 本事务
+     */
+    Transaction& operator=(Transaction&& other) noexcept;
+    
+    /**
+     * @brief 添加学生
+     * @param student 要添加的学生对象
+     */
+    void add_student(const Student& student);
+    
+    /**
+     * @brief 替换学生信息（可修改学号）
+     * @param student_id 要修改的学生学号
+     * @param new_student 新的学生信息
+     */
+    void update_student(const std::string& student_id, const Student& new_student);
+    
+    /**
+     * @brief 删除学生
+     * @param student_id 要删除的学生学号
+     */
+    void delete_student(const std::string& student_id);
+    
+    /**
+     * @brief 设置学生成绩
+     * @param student_id 学生学号
+     * @param subject 科目名称
+     * @param score 成绩（0-100分）
+     */
+    void set_score(const std::string& student_id, const std::string& subject, float score);
+    
+    /**
+     * @brief 调整学生班级
+     * @param student_id 学生学号
+     * @param class_id 新班级号
+     */
+    void set_class_id(const std::string& student_id, const std::string& class_id);
+    
+    /**
+     * @brief 获取已记录的操作数
+     * @return size_t 操作数
+     */
+    size_t size() const { return ops_.size(); }
+    
+    /**
+     * @brief 事务是否仍可提交
+     * @return bool 未提交且未回滚返回true
+     */
+    bool is_active() const { return active_; }
+
+private:
+    friend class StudentManagementSystem;
+    
+    Transaction() = default;
+    
+    std::vector<TransactionOp> ops_;  ///< 按调用顺序记录的操作
+    bool active_ = true;              ///< 是否仍可提交
+};
@@ -0,0 +1,155 @@
+/**
+ * @file undo_history.hh
+ * @brief 撤销/重做历史
+ * 
+ * 以字段级逆向增量记录每次修改，存放在定长环形缓冲区中，
+ * 避免为撤销保存完整的学生副本。同一批次（如一次增量导入）的记录整体撤销。
+ */
+
+#pragma once
+
+#include "student.hh"
+#include "student_schema.hh"
+#include "ring_buffer.hh"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @struct FieldDelta
+ * @brief 单个字段的修改前后值
+ */
+struct FieldDelta {
+    StudentField field;     ///< 字段
+    std::string old_value;  ///< 修改前的值
+    std::string new_value;  ///< 修改后的值
+};
+
+/**
+ * @struct ScoreDelta
+ * @brief 单科成绩的修改前后值（-1表示该科目不存在）
+ */
+struct ScoreDelta {
+    std::string subject;     ///< 科目
+    float old_score = -1.0f; ///< 修改前成绩
+    float new_score = -1.0f; ///< 修改后成绩
+};
+
+/**
+ * @enum UndoKind
+ * @brief 历史记录类型
+ */
+enum class UndoKind : uint8_t {
+    INSERT,  ///< 新增学生（只记录学号）
+    ERASE,   ///< 删除学生（保存被删除的记录以便恢复）
+    UPDATE,  ///< 修改学生（只记录发生变化的字段和成绩）
+    SCORE    ///< 设置单科成绩
+};
+
+/**
+ * @struct UndoRecord
+ * @brief 单条历史记录
+ * 
+ * student_id为操作完成后学生的学号（ERASE为被删除学生的学号）。
+ * 只有ERASE记录和已撤销的INSERT记录持有完整学生对象。
+ */
+struct UndoRecord {
+    UndoKind kind = UndoKind::INSERT;   ///< 记录类型
+    uint64_t group = 0;                 ///< 批次编号，同一批次整体撤销/重做
+    std::string student_id;             ///< 学号
+    std::vector<FieldDelta> fields;     ///< UPDATE时变化的字段
+    std::vector<ScoreDelta> scores;     ///< UPDATE/SCORE时变化的成绩
+    std::unique_ptr<Student> detached;  ///< 暂存的完整学生记录
+};
+
+/**
+ * @class UndoHistory
+ * @brief 有界撤销/重做历史
+ * 
+ * 撤销栈和重做栈均为定长环形缓冲区，写满后丢弃最旧的整个批次。
+ * 单个批次超过容量时无法整体撤销，此时清空撤销栈并丢弃该批次其余记录。
+ * 记录新的修改会清空重做栈。
+ */
+class UndoHistory {
+public:
+    /**
+     * @brief 构造函数
+     * @param capacity 撤销栈和重做栈各自最多保存的记录数
+     */
+    explicit UndoHistory(size_t capacity = 4096);
+    
+    /**
+     * @brief 开始批次，批次内的记录共享同一编号（可嵌套）
+     */
+    void begin_group();
+    
+    /**
+     * @brief 结束批次
+     */
+    void end_group();
+    
+    /**
+     * @brief 记录一次新的修改，并清空重做栈
+     * @param record 历史记录（group由本函数填写）
+     */
+    void record(UndoRecord record);
+    
+    /**
+     * @brief 弹出最近一个批次用于撤销
+     * @param out 输出参数，按从新到旧的顺序存放该批次记录
+     * @return bool 撤销栈为空返回false
+     */
+    bool pop_undo(std::vector<UndoRecord>& out);
+    
+    /**
+     * @brief 弹出最近一个已撤销批次用于重做
+     * @param out 输出参数，按从旧到新的顺序存放该批次记录
+     * @return bool 重做栈为空返回false
+     */
+    bool pop_redo(std::vector<UndoRecord>& out);
+    
+    /**
+     * @brief 将已撤销的批次压入重做栈
+     * @param records pop_undo得到的记录（从新到旧）
+     */
+    void push_redo(std::vector<UndoRecord>& records);
+    
+    /**
+     * @brief 将已重做的批次压回撤销栈（不清空重做栈）
+     * @param records pop_redo得到的记录（从旧到新）
+     */
+    void push_undo(std::vector<UndoRecord>& records);
+    
+    /**
+     * @brief 清空全部历史
+     */
+    void clear();
+    
+    size_t undo_size() const { return undo_.size(); } ///< 撤销栈记录数
+    size_t redo_size() const { return redo_.size(); } ///< 重做栈记录数
+    
+    /**
+     * @brief 生成修改记录（只包含发生变化的字段和成绩）
+     * @param before 修改前的学生
+     * @param after 修改后的学生
+     * @return UndoRecord UPDATE类型的历史记录
+     */
+    static UndoRecord make_update(const Student& before, const Student& after);
+
+private:
+    RingBuffer<UndoRecord> undo_;  ///< 撤销栈
+    RingBuffer<UndoRecord> redo_;  ///< 重做栈
+    uint64_t next_group_ = 1;      ///< 下一个批次编号
+    uint64_t current_group_ = 0;   ///< 当前打开的批次编号
+    int group_depth_ = 0;          ///< 批次嵌套深度
+    uint64_t dropped_group_ = 0;   ///< 因超过容量而放弃记录的批次编号
+    
+    /**
+     * @brief 压入记录，环形缓冲区写满时丢弃最旧批次的全部记录
+     * @param ring 目标环形缓冲区
+     * @param record 历史记录
+     * @return bool 需要丢弃的正是该记录所在批次时返回false（记录未压入）
+     */
+    static bool push_bounded(RingBuffer<UndoRecord>& ring, UndoRecord record);
+};
@@ -0,0 +1,578 @@
+#include "async_file.hh"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <new>
+#include <utility>
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#if defined(__linux__) && defined(__has_include) && !defined(SMS_NO_IO_URING)
+#if __has_include(<linux/io_uring.h>)
+#define SMS_HAVE_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+namespace {
+
+constexpr size_t IO_ALIGNMENT = 4096;  ///< 直接I/O要求的缓冲区、偏移和长度对齐
+
+/**
+ * @brief 分配按IO_ALIGNMENT对齐的块缓冲区
+ * @return char* 缓冲区
+ */
+char* allocate_chunk() {
+    return static_cast<char*>(::operator new(FileReader::CHUNK_SIZE, std::align_val_t(IO_ALIGNMENT)));
+}
+
+/**
+ * @brief 释放块缓冲区
+ * @param data 缓冲区（可为nullptr）
+ */
+void free_chunk(char* data) {
+    if (data) ::operator delete(data, std::align_val_t(IO_ALIGNMENT));
+}
+
+/**
+ * @brief 打开文件
+ * @param filename 文件名
+ * @param write true为创建或截断后写出，false为只读
+ * @return int 文件描述符，失败返回-1
+ */
+int open_file(const std::string& filename, bool write) {
+#ifdef _WIN32
+    int flags = _O_BINARY | (write ? (_O_WRONLY | _O_CREAT | _O_TRUNC) : _O_RDONLY);
+    return _open(filename.c_str(), flags, _S_IREAD | _S_IWRITE);
+#else
+    int flags = O_CLOEXEC | (write ? (O_WRONLY | O_CREAT | O_TRUNC) : O_RDONLY);
+    return ::open(filename.c_str(), flags, 0644);
+#endif
+}
+
+/**
+ * @brief 开启或关闭已打开文件的直接I/O
+ * @param fd 文件描述符
+ * @param enabled true为开启
+ * @return bool 设置成功返回true（平台或文件系统不支持时返回false）
+ */
+bool set_direct(int fd, bool enabled) {
+#if !defined(_WIN32) && defined(O_DIRECT)
+    int flags = fcntl(fd, F_GETFL);
+    if (flags < 0) return false;
+    if (((flags & O_DIRECT) != 0) == enabled) return true;
+    return fcntl(fd, F_SETFL, enabled ? (flags | O_DIRECT) : (flags & ~O_DIRECT)) == 0;
+#else
+    (void)fd;
+    return !enabled;
+#endif
+}
+
+/**
+ * @brief 关闭文件
+ * @param fd 文件描述符
+ */
+void close_file(int fd) {
+#ifdef _WIN32
+    _close(fd);
+#else
+    ::close(fd);
+#endif
+}
+
+/**
+ * @brief 在指定偏移读写一次
+ * @param write true为写出，false为读取
+ * @param fd 文件描述符
+ * @param data 缓冲区
+ * @param length 长度
+ * @param offset 文件偏移
+ * @return long 传输的字节数，失败返回负的错误码
+ */
+long transfer_at(bool write, int fd, char* data, size_t length, uint64_t offset) {
+#ifdef _WIN32
+    if (_lseeki64(fd, static_cast<__int64>(offset), SEEK_SET) < 0) return -errno;
+    unsigned count = static_cast<unsigned>(std::min<size_t>(length, 1u << 30));
+    int result = write ? _write(fd, data, count) : _read(fd, data, count);
+#else
+    ssize_t result;
+    do {
+        result = write ? ::pwrite(fd, data, length, static_cast<off_t>(offset))
+                       : ::pread(fd, data, length, static_cast<off_t>(offset));
+    } while (result < 0 && errno == EINTR);
+#endif
+    return result < 0 ? -errno : static_cast<long>(result);
+}
+
+/**
+ * @brief 同步完成一个请求剩余的部分
+ * @param write true为写出，false为读取
+ * @param fd 文件描述符
+ * @param data 缓冲区
+ * @param length 请求长度
+ * @param offset 文件偏移
+ * @param done 已完成的字节数，负数表示异步请求失败（错误码）
+ * @return long 最终完成的字节数（读取遇到文件末尾时可能小于length），失败返回负的错误码
+ * 
+ * 直接I/O因对齐等原因被拒绝（EINVAL）时，去掉O_DIRECT后重试。
+ */
+long finish_sync(bool write, int fd, char* data, size_t length, uint64_t offset, long done) {
+    size_t total = done > 0 ? static_cast<size_t>(done) : 0;
+    while (total < length) {
+        long result = transfer_at(write, fd, data + total, length - total, offset + total);
+#if !defined(_WIN32) && defined(O_DIRECT)
+        int flags = result == -EINVAL ? fcntl(fd, F_GETFL) : 0;
+        if (flags > 0 && (flags & O_DIRECT) && set_direct(fd, false)) continue;
+#endif
+        if (result < 0) return result;
+        if (result == 0) break;  // 文件末尾
+        total += static_cast<size_t>(result);
+    }
+    return static_cast<long>(total);
+}
+
+/**
+ * @brief 获取文件长度
+ * @param fd 文件描述符
+ * @param size 输出参数，文件长度
+ * @return bool 成功返回true
+ */
+bool file_size(int fd, uint64_t& size) {
+#ifdef _WIN32
+    __int64 length = _filelengthi64(fd);
+    if (length < 0) return false;
+    size = static_cast<uint64_t>(length);
+#else
+    struct stat info;
+    if (fstat(fd, &info) != 0) return false;
+    size = static_cast<uint64_t>(info.st_size);
+#endif
+    return true;
+}
+
+/**
+ * @brief 把文件截断到指定长度（去掉直接I/O写出的对齐填充）
+ * @param fd 文件描述符
+ * @param size 长度
+ * @return bool 成功返回true
+ */
+bool truncate_file(int fd, uint64_t size) {
+#ifdef _WIN32
+    return _chsize_s(fd, static_cast<__int64>(size)) == 0;
+#else
+    return ftruncate(fd, static_cast<off_t>(size)) == 0;
+#endif
+}
+
+} // namespace
+
+/**
+ * @class IoQueue
+ * @brief 读写请求队列
+ * 
+ * 有io_uring时请求提交给内核异步执行，完成顺序不定；
+ * 否则在提交时同步执行，wait按提交顺序返回结果。
+ */
+class IoQueue {
+public:
+    /**
+     * @brief 构造函数，尝试建立io_uring
+     * @param entries 最多同时在途的请求数
+     */
+    explicit IoQueue(unsigned entries);
+    
+    /**
+     * @brief 析构函数，释放io_uring（调用方须先等待全部请求完成）
+     */
+    ~IoQueue();
+    
+    IoQueue(const IoQueue&) = delete;
+    IoQueue& operator=(const IoQueue&) = delete;
+    
+    /**
+     * @brief 提交请求
+     * @param write true为写出，false为读取
+     * @param fd 文件描述符
+     * @param data 缓冲区（完成前须保持有效）
+     * @param length 长度
+     * @param offset 文件偏移
+     * @param tag 请求标记，完成时原样返回
+     */
+    void submit(bool write, int fd, char* data, size_t length, uint64_t offset, uint64_t tag);
+    
+    /**
+     * @brief 等待任意一个请求完成
+     * @param tag 输出参数，完成请求的标记
+     * @param result 输出参数，传输的字节数或负的错误码
+     */
+    void wait(uint64_t& tag, long& result);
+    
+    bool uses_io_uring() const { return ring_fd_ >= 0; }  ///< 是否使用io_uring
+
+private:
+    int ring_fd_ = -1;                                ///< io_uring文件描述符，-1表示同步执行
+    std::deque<std::pair<uint64_t, long>> completed_;  ///< 同步执行的请求结果
+#ifdef SMS_HAVE_IO_URING
+    void* sq_ring_ = nullptr;          ///< 提交队列映射
+    size_t sq_ring_size_ = 0;          ///< 提交队列映射长度
+    void* cq_ring_ = nullptr;          ///< 完成队列映射（单次映射时与sq_ring_相同）
+    size_t cq_ring_size_ = 0;          ///< 完成队列映射长度
+    io_uring_sqe* sqes_ = nullptr;     ///< 提交队列项数组
+    size_t sqes_size_ = 0;             ///< 提交队列项数组映射长度
+    unsigned* sq_tail_ = nullptr;      ///< 提交队列尾
+    unsigned* sq_mask_ = nullptr;      ///< 提交队列掩码
+    unsigned* sq_array_ = nullptr;     ///< 提交队列下标数组
+    unsigned* cq_head_ = nullptr;      ///< 完成队列头
+    unsigned* cq_tail_ = nullptr;      ///< 完成队列尾
+    unsigned* cq_mask_ = nullptr;      ///< 完成队列掩码
+    io_uring_cqe* cqes_ = nullptr;     ///< 完成队列项数组
+    
+    /**
+     * @brief 通知内核提交请求或等待完成
+     * @param to_submit 要提交的请求数
+     * @param min_complete 至少等待完成的请求数
+     * @return int 成功返回非负数，失败返回-1（errno为错误码）
+     */
+    int enter(unsigned to_submit, unsigned min_complete) {
+        unsigned flags = min_complete > 0 ? IORING_ENTER_GETEVENTS : 0;
+        int result;
+        do {
+            result = static_cast<int>(syscall(__NR_io_uring_enter, ring_fd_, to_submit, min_complete, flags, nullptr, 0));
+        } while (result < 0 && errno == EINTR);
+        return result;
+    }
+#endif
+};
+
+IoQueue::IoQueue(unsigned entries) {
+#ifdef SMS_HAVE_IO_URING
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    int fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (fd < 0) return;  // 内核不支持或被禁止（如容器的seccomp策略），同步执行
+    
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_map = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_map) sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    
+    sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    cq_ring_ = single_map ? sq_ring_
+                          : mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    void* sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (sq_ring_ == MAP_FAILED || cq_ring_ == MAP_FAILED || sqes == MAP_FAILED) {
+        if (sqes != MAP_FAILED) munmap(sqes, sqes_size_);
+        if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) munmap(cq_ring_, cq_ring_size_);
+        if (sq_ring_ != MAP_FAILED) munmap(sq_ring_, sq_ring_size_);
+        sq_ring_ = cq_ring_ = nullptr;
+        ::close(fd);
+        return;
+    }
+    
+    char* sq = static_cast<char*>(sq_ring_);
+    char* cq = static_cast<char*>(cq_ring_);
+    sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sq_mask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cq_mask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    sqes_ = static_cast<io_uring_sqe*>(sqes);
+    ring_fd_ = fd;
+#else
+    (void)entries;
+#endif
+}
+
+IoQueue::~IoQueue() {
+#ifdef SMS_HAVE_IO_URING
+    if (ring_fd_ < 0) return;
+    munmap(sqes_, sqes_size_);
+    if (cq_ring_ != sq_ring_) munmap(cq_ring_, cq_ring_size_);
+    munmap(sq_ring_, sq_ring_size_);
+    ::close(ring_fd_);
+#endif
+}
+
+void IoQueue::submit(bool write, int fd, char* data, size_t length, uint64_t offset, uint64_t tag) {
+#ifdef SMS_HAVE_IO_URING
+    if (ring_fd_ >= 0) {
+        // 在途请求数不超过队列长度，提交队列不会满
+        unsigned tail = *sq_tail_;
+        unsigned index = tail & *sq_mask_;
+        io_uring_sqe& sqe = sqes_[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = write ? IORING_OP_WRITE : IORING_OP_READ;
+        sqe.fd = fd;
+        sqe.addr = reinterpret_cast<uint64_t>(data);
+        sqe.len = static_cast<uint32_t>(length);
+        sqe.off = offset;
+        sqe.user_data = tag;
+        sq_array_[index] = index;
+        __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+        if (enter(1, 0) >= 0) return;
+        
+        // 内核拒绝接收时撤回该项，改为同步执行
+        __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+    }
+#endif
+    completed_.emplace_back(tag, finish_sync(write, fd, data, length, offset, 0));
+}
+
+void IoQueue::wait(uint64_t& tag, long& result) {
+    if (!completed_.empty()) {
+        tag = completed_.front().first;
+        result = completed_.front().second;
+        completed_.pop_front();
+        return;
+    }
+#ifdef SMS_HAVE_IO_URING
+    while (true) {
+        unsigned head = *cq_head_;
+        if (head != __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+            const io_uring_cqe& cqe = cqes_[head & *cq_mask_];
+            tag = cqe.user_data;
+            result = cqe.res;
+            __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+            return;
+        }
+        if (enter(0, 1) < 0) break;
+    }
+#endif
+    // 不应到达：没有在途请求时调用了wait
+    tag = 0;
+    result = -EIO;
+}
+
+FileReader::FileReader() = default;
+
+FileReader::~FileReader() {
+    close();
+}
+
+bool FileReader::open(const std::string& filename, bool direct) {
+    close();
+    fd_ = open_file(filename, false);
+    if (fd_ < 0) return false;
+    if (!file_size(fd_, size_)) {
+        close();
+        return false;
+    }
+    
+    want_direct_ = direct;
+    
+    queue_ = std::make_unique<IoQueue>(static_cast<unsigned>(QUEUE_DEPTH));
+    slots_.resize(QUEUE_DEPTH);
+    for (size_t i = 0; i < QUEUE_DEPTH; ++i) {
+        slots_[i].data = allocate_chunk();
+        submit(i);
+    }
+    return true;
+}
+
+void FileReader::close() {
+    for (size_t i = 0; i < slots_.size(); ++i) wait(i);
+    for (auto& slot : slots_) free_chunk(slot.data);
+    slots_.clear();
+    queue_.reset();
+    if (fd_ >= 0) close_file(fd_);
+    fd_ = -1;
+    want_direct_ = false;
+    direct_ = false;
+    failed_ = false;
+    size_ = 0;
+    next_offset_ = 0;
+    current_ = 0;
+    holding_ = false;
+    line_data_ = nullptr;
+    line_size_ = 0;
+}
+
+bool FileReader::uses_io_uring() const {
+    return queue_ && queue_->uses_io_uring();
+}
+
+void FileReader::submit(size_t slot) {
+    Slot& s = slots_[slot];
+    s.ready = false;
+    if (next_offset_ >= size_) return;
+    if (want_direct_ && !direct_ && next_offset_ >= DIRECT_MIN_SIZE) {
+        // 前面的块都是整块读取，偏移和长度满足对齐要求；设置失败则保持普通读取
+        direct_ = set_direct(fd_, true);
+        want_direct_ = direct_;
+    }
+    s.offset = next_offset_;
+    next_offset_ += CHUNK_SIZE;
+    s.pending = true;
+    // 直接I/O的请求长度须对齐，整块请求在文件末尾返回实际长度
+    size_t length = direct_ ? CHUNK_SIZE : static_cast<size_t>(std::min<uint64_t>(CHUNK_SIZE, size_ - s.offset));
+    queue_->submit(false, fd_, s.data, length, s.offset, slot);
+}
+
+void FileReader::wait(size_t slot) {
+    while (slots_[slot].pending) {
+        uint64_t tag = 0;
+        long result = 0;
+        queue_->wait(tag, result);
+        Slot& done = slots_[static_cast<size_t>(tag)];
+        done.result = result;
+        done.pending = false;
+        done.ready = true;
+    }
+}
+
+bool FileReader::next(const char*& data, size_t& size) {
+    if (fd_ < 0 || failed_) return false;
+    
+    // 调用方已用完上一块，其槽位改读后面的块
+    if (holding_) {
+        submit((current_ + QUEUE_DEPTH - 1) % QUEUE_DEPTH);
+        holding_ = false;
+    }
+    
+    Slot& slot = slots_[current_];
+    wait(current_);
+    if (!slot.ready) return false;  // 文件已读完
+    slot.ready = false;
+    
+    // 异步读取失败或读得不足时同步补齐（文件在读取期间被截断视为失败）
+    size_t expected = static_cast<size_t>(std::min<uint64_t>(CHUNK_SIZE, size_ - slot.offset));
+    if (slot.result < 0 || static_cast<size_t>(slot.result) < expected) {
+        size_t length = direct_ ? CHUNK_SIZE : expected;
+        slot.result = finish_sync(false, fd_, slot.data, length, slot.offset, slot.result);
+        if (slot.result < 0 || static_cast<size_t>(slot.result) < expected) {
+            failed_ = true;
+            return false;
+        }
+    }
+    
+    data = slot.data;
+    size = expected;
+    current_ = (current_ + 1) % QUEUE_DEPTH;
+    holding_ = true;
+    return true;
+}
+
+bool FileReader::read_line(std::string& line) {
+    line.clear();
+    while (true) {
+        if (line_size_ == 0 && !next(line_data_, line_size_)) {
+            line_data_ = nullptr;
+            line_size_ = 0;
+            return !line.empty();  // 最后一行没有换行符
+        }
+        const char* end = static_cast<const char*>(std::memchr(line_data_, '\n', line_size_));
+        size_t length = end ? static_cast<size_t>(end - line_data_) : line_size_;
+        line.append(line_data_, length);
+        size_t consumed = end ? length + 1 : length;
+        line_data_ += consumed;
+        line_size_ -= consumed;
+        if (end) return true;
+    }
+}
+
+FileWriter::FileWriter() = default;
+
+FileWriter::~FileWriter() {
+    close();
+}
+
+bool FileWriter::open(const std::string& filename, bool direct) {
+    close();
+    fd_ = open_file(filename, true);
+    if (fd_ < 0) return false;
+    want_direct_ = direct;
+    
+    queue_ = std::make_unique<IoQueue>(static_cast<unsigned>(QUEUE_DEPTH));
+    slots_.resize(QUEUE_DEPTH);
+    for (auto& slot : slots_) slot.data = allocate_chunk();
+    return true;
+}
+
+void FileWriter::write(const char* data, size_t size) {
+    if (fd_ < 0) return;
+    while (size > 0) {
+        Slot& slot = slots_[current_];
+        size_t count = std::min(size, CHUNK_SIZE - slot.length);
+        std::memcpy(slot.data + slot.length, data, count);
+        slot.length += count;
+        data += count;
+        size -= count;
+        if (slot.length == CHUNK_SIZE) submit_current();
+    }
+}
+
+void FileWriter::submit_current() {
+    Slot& slot = slots_[current_];
+    if (want_direct_ && !direct_ && written_ >= DIRECT_MIN_SIZE) {
+        // 偏移是块大小的整数倍，满足对齐要求；设置失败则保持普通写出
+        direct_ = set_direct(fd_, true);
+        want_direct_ = direct_;
+    }
+    slot.offset = written_;
+    written_ += slot.length;
+    slot.request = slot.length;
+    if (direct_ && slot.request % IO_ALIGNMENT != 0) {
+        // 直接I/O的写出长度须对齐，补零后在close时截断
+        size_t padded = (slot.request + IO_ALIGNMENT - 1) / IO_ALIGNMENT * IO_ALIGNMENT;
+        std::memset(slot.data + slot.request, 0, padded - slot.request);
+        slot.request = padded;
+    }
+    slot.pending = true;
+    queue_->submit(true, fd_, slot.data, slot.request, slot.offset, current_);
+    
+    // 下一个槽位若仍在途，等它写完再复用
+    current_ = (current_ + 1) % QUEUE_DEPTH;
+    wait(current_);
+    slots_[current_].length = 0;
+}
+
+void FileWriter::wait(size_t slot) {
+    while (slots_[slot].pending) {
+        uint64_t tag = 0;
+        long result = 0;
+        queue_->wait(tag, result);
+        Slot& done = slots_[static_cast<size_t>(tag)];
+        done.pending = false;
+        if (result < 0 || static_cast<size_t>(result) < done.request) {
+            result = finish_sync(true, fd_, done.data, done.request, done.offset, result);
+            if (result < 0 || static_cast<size_t>(result) < done.request) failed_ = true;
+        }
+    }
+}
+
+bool FileWriter::close() {
+    if (fd_ < 0) return !failed_;
+    
+    if (slots_[current_].length > 0) submit_current();
+    for (size_t i = 0; i < slots_.size(); ++i) wait(i);
+    if (direct_ && !truncate_file(fd_, written_)) failed_ = true;
+    
+    for (auto& slot : slots_) free_chunk(slot.data);
+    slots_.clear();
+    queue_.reset();
+    close_file(fd_);
+    fd_ = -1;
+    want_direct_ = false;
+    direct_ = false;
+    written_ = 0;
+    current_ = 0;
+    bool success = !failed_;
+    failed_ = false;
+    return success;
+}
+
+bool FileWriter::uses_io_uring() const {
+    return queue_ && queue_->uses_io_uring();
+}
@@ -0,0 +1,183 @@
+#include "bk_tree.hh"
+#include "binary_io.hh"
+#include <algorithm>
+
+std::u32string utf8_to_codepoints(const std::string& text) {
+    std::u32string result;
+    result.reserve(text.size());
+    
+    for (size_t i = 0; i < text.size();) {
+        unsigned char lead = static_cast<unsigned char>(text[i]);
+        size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+        if (length == 0 || i + length > text.size()) {
+            result.push_back(lead);
+            ++i;
+            continue;
+        }
+        
+        char32_t codepoint = length == 1 ? lead : lead & (0xFF >> (length + 1));
+        for (size_t k = 1; k < length; ++k) {
+            codepoint = (codepoint << 6) | (static_cast<unsigned char>(text[i + k]) & 0x3F);
+        }
+        result.push_back(codepoint);
+        i += length;
+    }
+    return result;
+}
+
+int edit_distance(const std::u32string& a, const std::u32string& b) {
+    // 单行滚动数组的动态规划
+    std::vector<int> row(b.size() + 1);
+    for (size_t j = 0; j <= b.size(); ++j) row[j] = static_cast<int>(j);
+    
+    for (size_t i = 1; i <= a.size(); ++i) {
+        int diagonal = row[0];
+        row[0] = static_cast<int>(i);
+        for (size_t j = 1; j <= b.size(); ++j) {
+            int above = row[j];
+            int cost = a[i - 1] == b[j - 1] ? 0 : 1;
+            row[j] = std::min({above + 1, row[j - 1] + 1, diagonal + cost});
+            diagonal = above;
+        }
+    }
+    return row[b.size()];
+}
+
+long BKTree::find(const std::u32string& codepoints) const {
+    if (nodes_.empty()) return -1;
+    
+    uint32_t node = 0;
+    while (true) {
+        int distance = edit_distance(codepoints, nodes_[node].codepoints);
+        if (distance == 0) return static_cast<long>(node);
+        
+        auto child = std::find_if(nodes_[node].children.begin(), nodes_[node].children.end(),
+            [distance](const std::pair<int, uint32_t>& entry) { return entry.first == distance; });
+        if (child == nodes_[node].children.end()) return -1;
+        node = child->second;
+    }
+}
+
+void BKTree::insert(const std::string& key) {
+    insert(key, utf8_to_codepoints(key), 1);
+}
+
+void BKTree::insert(std::string key, std::u32string codepoints, uint32_t count) {
+    if (nodes_.empty()) {
+        nodes_.push_back({std::move(key), std::move(codepoints), count, {}});
+        return;
+    }
+    
+    uint32_t node = 0;
+    while (true) {
+        int distance = edit_distance(codepoints, nodes_[node].codepoints);
+        if (distance == 0) {
+            if (nodes_[node].count == 0) dead_nodes_--;
+            nodes_[node].count += count;
+            return;
+        }
+        
+        auto& children = nodes_[node].children;
+        auto child = std::find_if(children.begin(), children.end(),
+            [distance](const std::pair<int, uint32_t>& entry) { return entry.first == distance; });
+        if (child == children.end()) {
+            uint32_t index = static_cast<uint32_t>(nodes_.size());
+            children.emplace_back(distance, index);
+            nodes_.push_back({std::move(key), std::move(codepoints), count, {}});
+            return;
+        }
+        node = child->second;
+    }
+}
+
+bool BKTree::erase(const std::string& key) {
+    long node = find(utf8_to_codepoints(key));
+    if (node < 0 || nodes_[node].count == 0) return false;
+    if (--nodes_[node].count == 0 && ++dead_nodes_ * 2 > nodes_.size()) {
+        rebuild();
+    }
+    return true;
+}
+
+void BKTree::rebuild() {
+    std::vector<Node> old_nodes;
+    old_nodes.swap(nodes_);
+    dead_nodes_ = 0;
+    
+    // 码点序列直接移入新节点，不重新解码
+    for (auto& node : old_nodes) {
+        if (node.count > 0) insert(std::move(node.key), std::move(node.codepoints), node.count);
+    }
+}
+
+std::vector<std::pair<std::string, int>> BKTree::search(const std::string& query, int max_distance,
+                                                        size_t max_visits) const {
+    std::vector<std::pair<std::string, int>> result;
+    if (nodes_.empty()) return result;
+    
+    std::u32string codepoints = utf8_to_codepoints(query);
+    std::vector<uint32_t> pending = {0};
+    size_t visits = 0;
+    
+    while (!pending.empty() && visits < max_visits) {
+        uint32_t node = pending.back();
+        pending.pop_back();
+        ++visits;
+        
+        int distance = edit_distance(codepoints, nodes_[node].codepoints);
+        if (distance <= max_distance && nodes_[node].count > 0) {
+            result.emplace_back(nodes_[node].key, distance);
+        }
+        // 三角不等式：只有与本节点距离在[d-k, d+k]内的子树可能包含结果
+        for (const auto& [child_distance, child] : nodes_[node].children) {
+            if (child_distance >= distance - max_distance && child_distance <= distance + max_distance) {
+                pending.push_back(child);
+            }
+        }
+    }
+    
+    std::stable_sort(result.begin(), result.end(),
+        [](const std::pair<std::string, int>& a, const std::pair<std::string, int>& b) {
+            return a.second < b.second;
+        });
+    return result;
+}
+
+void BKTree::serialize(std::string& out) const {
+    write_pod(out, static_cast<uint64_t>(nodes_.size()));
+    for (const auto& node : nodes_) {
+        write_string(out, node.key);
+        write_pod(out, node.count);
+        write_pod(out, static_cast<uint32_t>(node.children.size()));
+        for (const auto& [distance, child] : node.children) {
+            write_pod(out, static_cast<int32_t>(distance));
+            write_pod(out, child);
+        }
+    }
+}
+
+bool BKTree::deserialize(const char* data, size_t size) {
+    BinaryReader reader(data, size);
+    uint64_t count = 0;
+    if (!reader.read(count) || count > size) return false;
+    
+    std::vector<Node> nodes(static_cast<size_t>(count));
+    for (auto& node : nodes) {
+        uint32_t child_count = 0;
+        if (!reader.read_string(node.key) || !reader.read(node.count) || !reader.read(child_count)) return false;
+        
+        node.codepoints = utf8_to_codepoints(node.key);
+        for (uint32_t i = 0; i < child_count; ++i) {
+            int32_t distance = 0;
+            uint32_t child = 0;
+            if (!reader.read(distance) || !reader.read(child) || child >= count) return false;
+            node.children.emplace_back(distance, child);
+        }
+    }
+    if (!reader.at_end()) return false;
+    
+    nodes_ = std::move(nodes);
+    dead_nodes_ = static_cast<size_t>(std::count_if(nodes_.begin(), nodes_.end(),
+        [](const Node& node) { return node.count == 0; }));
+    return true;
+}
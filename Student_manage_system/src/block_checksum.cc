@@ -0,0 +1,163 @@
+#include "block_checksum.hh"
+#include "async_file.hh"
+#include "binary_io.hh"
+#include "crc32c.hh"
+#include "mapped_file.hh"
+#include "thread_pool.hh"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <future>
+#include <thread>
+
+namespace {
+
+constexpr char MAGIC[8] = {'S', 'M', 'S', 'C', 'R', 'C', '0', '1'};  ///< 校验文件标识
+
+} // namespace
+
+bool BlockChecksums::checksum_file(const std::string& filename, uint32_t& crc, uint64_t& size) {
+    FileReader file;
+    if (!file.open(filename)) return false;
+    
+    crc = 0;
+    size = 0;
+    const char* chunk = nullptr;
+    size_t length = 0;
+    while (file.next(chunk, length)) {
+        size += length;
+        crc = crc32c(chunk, length, crc);
+    }
+    return !file.failed();
+}
+
+void BlockChecksums::update(const char* data, size_t size) {
+    while (size > 0) {
+        size_t filled = static_cast<size_t>(data_size_ % BLOCK_SIZE);
+        size_t take = std::min(size, BLOCK_SIZE - filled);
+        current_ = crc32c(data, take, current_);
+        data_size_ += take;
+        data += take;
+        size -= take;
+        if (data_size_ % BLOCK_SIZE == 0) {
+            blocks_.push_back(current_);
+            current_ = 0;
+        }
+    }
+}
+
+bool BlockChecksums::write(const std::string& filename, const std::string& data_filename) const {
+    int64_t mtime = 0;
+    if (!modification_time(data_filename, mtime)) return false;
+    std::vector<uint32_t> blocks = blocks_;
+    if (blocks.size() < block_count()) blocks.push_back(current_);
+    
+    std::string out(MAGIC, sizeof(MAGIC));
+    write_pod(out, static_cast<uint32_t>(BLOCK_SIZE));
+    write_pod(out, data_size_);
+    write_pod(out, mtime);
+    write_array(out, blocks);
+    write_pod(out, crc32c(out.data(), out.size()));
+    
+    std::string temp = filename + ".tmp";
+    {
+        FileWriter file;
+        if (!file.open(temp)) return false;
+        file.write(out);
+        if (!file.close()) {
+            std::remove(temp.c_str());
+            return false;
+        }
+    }
+    
+    std::remove(filename.c_str());
+    return std::rename(temp.c_str(), filename.c_str()) == 0;
+}
+
+bool BlockChecksums::read(const std::string& filename) {
+    data_size_ = 0;
+    data_mtime_ = 0;
+    blocks_.clear();
+    current_ = 0;
+    
+    MappedFile file;
+    if (!file.open(filename, sizeof(MAGIC) + sizeof(uint32_t)) ||
+        std::memcmp(file.data(), MAGIC, sizeof(MAGIC)) != 0) {
+        return false;
+    }
+    size_t body_size = file.size() - sizeof(uint32_t);
+    uint32_t stored = 0;
+    std::memcpy(&stored, file.data() + body_size, sizeof(stored));
+    if (stored != crc32c(file.data(), body_size)) return false;
+    
+    BinaryReader reader(file.data() + sizeof(MAGIC), body_size - sizeof(MAGIC));
+    uint32_t block_size = 0;
+    bool ok = reader.read(block_size) && reader.read(data_size_) && reader.read(data_mtime_) &&
+              reader.read_array(blocks_) && reader.at_end() &&
+              block_size == BLOCK_SIZE && blocks_.size() == block_count();
+    if (!ok) {
+        data_size_ = 0;
+        blocks_.clear();
+    }
+    return ok;
+}
+
+bool BlockChecksums::matches(const std::string& data_filename) const {
+    std::error_code error;
+    uint64_t size = std::filesystem::file_size(data_filename, error);
+    int64_t mtime = 0;
+    return !error && size == data_size_ && modification_time(data_filename, mtime) && mtime == data_mtime_;
+}
+
+bool BlockChecksums::verify(const std::string& data_filename, std::vector<uint64_t>& bad_blocks, size_t threads) const {
+    bad_blocks.clear();
+    MappedFile file;
+    if (data_size_ > 0 && (!file.open(data_filename) || file.size() != data_size_)) {
+        for (size_t i = 0; i < blocks_.size(); ++i) bad_blocks.push_back(i);
+        return false;
+    }
+    
+    auto check = [this, &file](size_t block) {
+        uint64_t offset = static_cast<uint64_t>(block) * BLOCK_SIZE;
+        size_t length = static_cast<size_t>(std::min<uint64_t>(BLOCK_SIZE, data_size_ - offset));
+        return crc32c(file.data() + offset, length) == blocks_[block];
+    };
+    
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, std::max<size_t>(1, blocks_.size()));
+    if (threads == 1) {
+        for (size_t i = 0; i < blocks_.size(); ++i) {
+            if (!check(i)) bad_blocks.push_back(i);
+        }
+        return bad_blocks.empty();
+    }
+    
+    // 每个线程负责连续的一段块，减少任务数
+    ThreadPool pool(threads);
+    size_t per_task = (blocks_.size() + threads - 1) / threads;
+    std::vector<std::future<std::vector<uint64_t>>> results;
+    for (size_t first = 0; first < blocks_.size(); first += per_task) {
+        size_t last = std::min(blocks_.size(), first + per_task);
+        results.push_back(pool.submit([&check, first, last]() {
+            std::vector<uint64_t> bad;
+            for (size_t i = first; i < last; ++i) {
+                if (!check(i)) bad.push_back(i);
+            }
+            return bad;
+        }));
+    }
+    for (auto& result : results) {
+        std::vector<uint64_t> bad = result.get();
+        bad_blocks.insert(bad_blocks.end(), bad.begin(), bad.end());
+    }
+    return bad_blocks.empty();
+}
+
+bool BlockChecksums::modification_time(const std::string& data_filename, int64_t& mtime) {
+    std::error_code error;
+    auto time = std::filesystem::last_write_time(data_filename, error);
+    if (error) return false;
+    mtime = static_cast<int64_t>(time.time_since_epoch().count());
+    return true;
+}
@@ -0,0 +1,87 @@
+#include "bloom_filter.hh"
+#include "binary_io.hh"
+
+BloomFilter::BloomFilter(size_t capacity, size_t bits_per_key)
+    : bits_per_key_(bits_per_key) {
+    reset(capacity);
+}
+
+void BloomFilter::reset(size_t capacity) {
+    capacity_ = capacity == 0 ? 1 : capacity;
+    block_count_ = (capacity_ * bits_per_key_ + BLOCK_WORDS * 64 - 1) / (BLOCK_WORDS * 64);
+    bits_.assign(block_count_ * BLOCK_WORDS, 0);
+    size_ = 0;
+}
+
+void BloomFilter::insert(uint64_t h) {
+    uint64_t* block = &bits_[(h >> 32) % block_count_ * BLOCK_WORDS];
+    
+    // 块内用双重哈希生成HASH_COUNT个位置
+    uint32_t h1 = static_cast<uint32_t>(h);
+    uint32_t h2 = static_cast<uint32_t>((h * 0x9e3779b97f4a7c15ULL) >> 32) | 1;
+    for (int i = 0; i < HASH_COUNT; ++i) {
+        uint32_t bit = (h1 + i * h2) & (BLOCK_WORDS * 64 - 1);
+        block[bit / 64] |= 1ULL << (bit % 64);
+    }
+    ++size_;
+}
+
+bool BloomFilter::may_contain(uint64_t h) const {
+    queries_.fetch_add(1, std::memory_order_relaxed);
+    
+    const uint64_t* block = &bits_[(h >> 32) % block_count_ * BLOCK_WORDS];
+    
+    uint32_t h1 = static_cast<uint32_t>(h);
+    uint32_t h2 = static_cast<uint32_t>((h * 0x9e3779b97f4a7c15ULL) >> 32) | 1;
+    for (int i = 0; i < HASH_COUNT; ++i) {
+        uint32_t bit = (h1 + i * h2) & (BLOCK_WORDS * 64 - 1);
+        if ((block[bit / 64] & (1ULL << (bit % 64))) == 0) {
+            negatives_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+    return true;
+}
+
+void BloomFilter::record_false_positive() const {
+    false_positives_.fetch_add(1, std::memory_order_relaxed);
+}
+
+BloomFilterStats BloomFilter::stats() const {
+    BloomFilterStats result;
+    result.queries = queries_.load(std::memory_order_relaxed);
+    result.negatives = negatives_.load(std::memory_order_relaxed);
+    result.false_positives = false_positives_.load(std::memory_order_relaxed);
+    return result;
+}
+
+void BloomFilter::serialize(std::string& out) const {
+    write_pod(out, static_cast<uint64_t>(capacity_));
+    write_pod(out, static_cast<uint64_t>(bits_per_key_));
+    write_pod(out, static_cast<uint64_t>(size_));
+    write_array(out, bits_);
+}
+
+bool BloomFilter::deserialize(const char* data, size_t size) {
+    BinaryReader reader(data, size);
+    uint64_t capacity = 0;
+    uint64_t bits_per_key = 0;
+    uint64_t inserted = 0;
+    std::vector<uint64_t> bits;
+    if (!reader.read(capacity) || !reader.read(bits_per_key) || !reader.read(inserted) ||
+        !reader.read_array(bits) || !reader.at_end()) {
+        return false;
+    }
+    
+    // 块数由容量和每键比特数决定，两者须与比特数组长度一致
+    if (capacity == 0 || bits_per_key == 0 || bits_per_key > 64 || capacity > size * 8) return false;
+    size_t block_count = static_cast<size_t>((capacity * bits_per_key + BLOCK_WORDS * 64 - 1) / (BLOCK_WORDS * 64));
+    if (block_count == 0 || bits.size() != block_count * BLOCK_WORDS) return false;
+    
+    capacity_ = static_cast<size_t>(capacity);
+    bits_per_key_ = static_cast<size_t>(bits_per_key);
+    size_ = static_cast<size_t>(inserted);
+    block_count_ = block_count;
+    bits_ = std::move(bits);
+    return true;
+}
@@ -0,0 +1,238 @@
+#include "change_stream.hh"
+#include "csv_codec.hh"
+#include <chrono>
+#include <sstream>
+
+namespace {
+
+int64_t now_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+ChangeStream::ChangeStream(size_t ring_capacity) : ring_(ring_capacity) {}
+
+int ChangeStream::subscribe(Callback callback) {
+    std::lock_guard<std::mutex> lock(subscribers_mutex_);
+    int id = next_subscription_id_++;
+    subscribers_[id] = std::move(callback);
+    subscriber_count_ = subscribers_.size();
+    return id;
+}
+
+void ChangeStream::unsubscribe(int subscription_id) {
+    std::lock_guard<std::mutex> lock(subscribers_mutex_);
+    subscribers_.erase(subscription_id);
+    subscriber_count_ = subscribers_.size();
+}
+
+bool ChangeStream::open_log(const std::string& filename) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (log_.is_open()) log_.close();
+    
+    // 续接已有日志的序列号，保证同一日志文件内序列号单调递增
+    uint64_t last = read_last_sequence(filename);
+    if (last >= next_sequence_) next_sequence_ = last + 1;
+    
+    log_.open(filename, std::ios::app);
+    log_open_ = log_.is_open();
+    return log_.is_open();
+}
+
+void ChangeStream::close_log() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (log_.is_open()) log_.close();
+    log_open_ = false;
+}
+
+bool ChangeStream::is_log_open() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return log_.is_open();
+}
+
+uint64_t ChangeStream::publish(ChangeEvent event) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        event.sequence = next_sequence_++;
+        event.timestamp_ms = now_ms();
+        
+        if (log_.is_open()) {
+            log_ << serialize(event) << '\n';
+            if (batch_depth_ == 0) log_.flush();
+        }
+        ring_.push_back(event);
+    }
+    
+    std::lock_guard<std::mutex> lock(subscribers_mutex_);
+    for (const auto& [id, callback] : subscribers_) {
+        callback(event);
+    }
+    return event.sequence;
+}
+
+uint64_t ChangeStream::publish_snapshot(const std::list<Student>& students) {
+    if (!has_consumers()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        next_sequence_ += students.size() + 1;
+        ring_.clear();
+        return next_sequence_ - 1;
+    }
+    
+    ChangeEvent marker;
+    marker.type = ChangeType::SNAPSHOT;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        marker.timestamp_ms = now_ms();
+        if (log_.is_open()) {
+            // 与serialize对ADD事件的编码相同，只是直接从名册中的学生编码
+            std::string prefix = '\t' + std::to_string(marker.timestamp_ms) + '\t' +
+                                 std::to_string(static_cast<int>(ChangeType::ADD)) + '\t';
+            std::string line;
+            for (const auto& student : students) {
+                line = std::to_string(next_sequence_++);
+                line += prefix;
+                line += student.get_id();
+                line += '\t';
+                append_student_csv(line, student);
+                log_ << line;
+            }
+        } else {
+            next_sequence_ += students.size();
+        }
+        
+        marker.sequence = next_sequence_++;
+        if (log_.is_open()) {
+            log_ << serialize(marker) << '\n';
+            if (batch_depth_ == 0) log_.flush();
+        }
+        ring_.clear();
+        ring_.push_back(marker);
+    }
+    
+    std::lock_guard<std::mutex> lock(subscribers_mutex_);
+    for (const auto& [id, callback] : subscribers_) {
+        callback(marker);
+    }
+    return marker.sequence;
+}
+
+uint64_t ChangeStream::skip() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ring_.clear();
+    return next_sequence_++;
+}
+
+void ChangeStream::begin_batch() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++batch_depth_;
+}
+
+void ChangeStream::end_batch() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (batch_depth_ > 0 && --batch_depth_ == 0 && log_.is_open()) {
+        log_.flush();
+    }
+}
+
+bool ChangeStream::read_since(uint64_t after_sequence, std::vector<ChangeEvent>& out,
+                              size_t max_events) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    polled_ = true;
+    if (ring_.empty()) return after_sequence + 1 >= next_sequence_;
+    
+    uint64_t oldest = ring_.at(0).sequence;
+    if (after_sequence + 1 < oldest) return false;
+    
+    // 环形缓冲区内序列号连续，可直接换算逻辑下标
+    for (size_t i = after_sequence + 1 - oldest; i < ring_.size() && max_events > 0; ++i, --max_events) {
+        out.push_back(ring_.at(i));
+    }
+    return true;
+}
+
+uint64_t ChangeStream::last_sequence() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    polled_ = true;
+    return next_sequence_ - 1;
+}
+
+std::string ChangeStream::serialize(const ChangeEvent& event) {
+    std::ostringstream oss;
+    oss << event.sequence << '\t' << event.timestamp_ms << '\t'
+        << static_cast<int>(event.type) << '\t' << event.student_id << '\t';
+    
+    switch (event.type) {
+        case ChangeType::ADD:
+        case ChangeType::UPDATE:
+            oss << student_to_csv(event.student);
+            break;
+        case ChangeType::SCORE_SET:
+            oss << event.subject << ':' << event.score;
+            break;
+        default:
+            break;
+    }
+    return oss.str();
+}
+
+bool ChangeStream::deserialize(const std::string& line, ChangeEvent& event) {
+    std::istringstream iss(line);
+    std::string sequence, timestamp, type, payload;
+    
+    if (!(std::getline(iss, sequence, '\t') &&
+          std::getline(iss, timestamp, '\t') &&
+          std::getline(iss, type, '\t') &&
+          std::getline(iss, event.student_id, '\t'))) {
+        return false;
+    }
+    std::getline(iss, payload);
+    
+    try {
+        event.sequence = std::stoull(sequence);
+        event.timestamp_ms = std::stoll(timestamp);
+        int type_value = std::stoi(type);
+        if (type_value < 0 || type_value > static_cast<int>(ChangeType::SNAPSHOT)) return false;
+        event.type = static_cast<ChangeType>(type_value);
+        
+        switch (event.type) {
+            case ChangeType::ADD:
+            case ChangeType::UPDATE:
+                return student_from_csv(payload, event.student);
+            case ChangeType::SCORE_SET: {
+                size_t colon_pos = payload.rfind(':');
+                if (colon_pos == std::string::npos) return false;
+                event.subject = payload.substr(0, colon_pos);
+                event.score = std::stof(payload.substr(colon_pos + 1));
+                return true;
+            }
+            default:
+                return true;
+        }
+    } catch (const std::exception& e) {
+        return false;
+    }
+}
+
+uint64_t ChangeStream::read_last_sequence(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return 0;
+    
+    // 只读取文件末尾一段，找到最后一个完整行
+    std::streamoff size = file.tellg();
+    std::streamoff start = size > 4096 ? size - 4096 : 0;
+    file.seekg(start);
+    std::string tail(static_cast<size_t>(size - start), '\0');
+    file.read(&tail[0], static_cast<std::streamsize>(tail.size()));
+    
+    while (!tail.empty() && tail.back() == '\n') tail.pop_back();
+    size_t line_start = tail.rfind('\n');
+    std::string last_line = line_start == std::string::npos ? tail : tail.substr(line_start + 1);
+    
+    try {
+        return std::stoull(last_line.substr(0, last_line.find('\t')));
+    } catch (const std::exception& e) {
+        return 0;
+    }
+}
@@ -0,0 +1,132 @@
+#include "crc32c.hh"
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SMS_CRC32C_X86 1
+#include <nmmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#define SMS_CRC32C_ARM 1
+#include <arm_acle.h>
+#endif
+
+namespace {
+
+constexpr uint32_t POLYNOMIAL = 0x82F63B78u;  ///< CRC32C多项式（反射形式）
+
+/**
+ * @struct Tables
+ * @brief 查表法的8张表，第k张表对应后面还有k个字节时一个字节的贡献
+ */
+struct Tables {
+    uint32_t entries[8][256];
+    
+    Tables() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) crc = (crc >> 1) ^ (POLYNOMIAL & (0u - (crc & 1u)));
+            entries[0][i] = crc;
+        }
+        for (uint32_t i = 0; i < 256; ++i) {
+            for (int k = 1; k < 8; ++k) {
+                entries[k][i] = (entries[k - 1][i] >> 8) ^ entries[0][entries[k - 1][i] & 0xff];
+            }
+        }
+    }
+};
+
+/**
+ * @brief 查表法，按字节组装字，与字节序无关
+ * @param crc 取反后的CRC状态
+ * @param p 数据
+ * @param size 长度
+ * @return uint32_t 新的CRC状态
+ */
+uint32_t crc32c_table(uint32_t crc, const unsigned char* p, size_t size) {
+    static const Tables tables;
+    const auto& t = tables.entries;
+    while (size >= 8) {
+        uint32_t low = crc ^ (static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 |
+                              static_cast<uint32_t>(p[2]) << 16 | static_cast<uint32_t>(p[3]) << 24);
+        uint32_t high = static_cast<uint32_t>(p[4]) | static_cast<uint32_t>(p[5]) << 8 |
+                        static_cast<uint32_t>(p[6]) << 16 | static_cast<uint32_t>(p[7]) << 24;
+        crc = t[7][low & 0xff] ^ t[6][(low >> 8) & 0xff] ^ t[5][(low >> 16) & 0xff] ^ t[4][low >> 24] ^
+              t[3][high & 0xff] ^ t[2][(high >> 8) & 0xff] ^ t[1][(high >> 16) & 0xff] ^ t[0][high >> 24];
+        p += 8;
+        size -= 8;
+    }
+    while (size-- > 0) crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xff];
+    return crc;
+}
+
+#if defined(SMS_CRC32C_X86)
+/**
+ * @brief SSE4.2 crc32指令实现（只在运行时检测到SSE4.2后调用）
+ */
+__attribute__((target("sse4.2")))
+uint32_t crc32c_hardware(uint32_t crc, const unsigned char* p, size_t size) {
+    while (size > 0 && (reinterpret_cast<uintptr_t>(p) & 7) != 0) {
+        crc = _mm_crc32_u8(crc, *p++);
+        --size;
+    }
+    uint64_t state = crc;
+    while (size >= 8) {
+        uint64_t word;
+        std::memcpy(&word, p, sizeof(word));
+        state = _mm_crc32_u64(state, word);
+        p += 8;
+        size -= 8;
+    }
+    crc = static_cast<uint32_t>(state);
+    while (size-- > 0) crc = _mm_crc32_u8(crc, *p++);
+    return crc;
+}
+#elif defined(SMS_CRC32C_ARM)
+/**
+ * @brief ARMv8 CRC扩展指令实现
+ */
+uint32_t crc32c_hardware(uint32_t crc, const unsigned char* p, size_t size) {
+    while (size > 0 && (reinterpret_cast<uintptr_t>(p) & 7) != 0) {
+        crc = __crc32cb(crc, *p++);
+        --size;
+    }
+    while (size >= 8) {
+        uint64_t word;
+        std::memcpy(&word, p, sizeof(word));
+        crc = __crc32cd(crc, word);
+        p += 8;
+        size -= 8;
+    }
+    while (size-- > 0) crc = __crc32cb(crc, *p++);
+    return crc;
+}
+#endif
+
+using Implementation = uint32_t (*)(uint32_t, const unsigned char*, size_t);
+
+/**
+ * @brief 选择当前CPU可用的实现
+ * @return Implementation 实现函数
+ */
+Implementation select_implementation() {
+#if defined(SMS_CRC32C_X86)
+    if (__builtin_cpu_supports("sse4.2")) return crc32c_hardware;
+#elif defined(SMS_CRC32C_ARM)
+    return crc32c_hardware;
+#endif
+    return crc32c_table;
+}
+
+const Implementation& implementation() {
+    static const Implementation selected = select_implementation();
+    return selected;
+}
+
+} // namespace
+
+uint32_t crc32c(const void* data, size_t size, uint32_t crc) {
+    return ~implementation()(~crc, static_cast<const unsigned char*>(data), size);
+}
+
+bool crc32c_uses_hardware() {
+    return implementation() != crc32c_table;
+}
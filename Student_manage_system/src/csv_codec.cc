@@ -0,0 +1,106 @@
+#include "csv_codec.hh"
+#include "student_schema.hh"
+#include <array>
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+
+using student_schema::StudentFields;
+
+const std::string& csv_header() {
+    static const std::string header = [] {
+        std::string text;
+        StudentFields::for_each([&](auto descriptor) {
+            text += decltype(descriptor)::LABEL;
+            text += ',';
+        });
+        return text + student_schema::SCORES_LABEL + "\n";
+    }();
+    return header;
+}
+
+std::string student_to_csv(const Student& student) {
+    std::string line;
+    append_student_csv(line, student);
+    line.pop_back();
+    return line;
+}
+
+void append_student_csv(std::string& buffer, const Student& student) {
+    StudentFields::for_each([&](auto descriptor) {
+        buffer += decltype(descriptor)::get(student);
+        buffer += ',';
+    });
+    
+    // 成绩按与std::ostream默认格式相同的%g输出
+    const auto& scores = student.get_scores();
+    if (!scores.empty()) {
+        bool first = true;
+        for (const auto& [subject, score] : scores) {
+            if (!first) buffer += ';';
+            buffer += subject;
+            buffer += ':';
+            char text[32];
+            int length = std::snprintf(text, sizeof(text), "%g", score);
+            buffer.append(text, static_cast<size_t>(length));
+            first = false;
+        }
+    } else {
+        buffer += "无成绩";
+    }
+    buffer += '\n';
+}
+
+bool student_from_csv(const std::string& line, Student& student,
+                      std::vector<std::string>* skipped_scores, const ColumnSet& columns) {
+    // 先找出各列的起点，列数不对时不做验证；最后一列成绩信息可以含逗号，但不能为空
+    std::array<size_t, StudentFields::SIZE + 1> starts;
+    starts[0] = 0;
+    for (size_t i = 0; i < StudentFields::SIZE; ++i) {
+        size_t comma = line.find(',', starts[i]);
+        if (comma == std::string::npos) return false;
+        starts[i + 1] = comma + 1;
+    }
+    if (starts.back() >= line.size()) return false;
+    
+    // 按列顺序验证并设置需要的字段，其余列不复制也不验证
+    Student decoded;
+    std::string value;
+    size_t column = 0;
+    StudentFields::for_each([&](auto descriptor) {
+        using Field = decltype(descriptor);
+        if (columns.has(Field::KEY)) {
+            value.assign(line, starts[column], starts[column + 1] - 1 - starts[column]);
+            Field::set(decoded, value);
+        }
+        ++column;
+    });
+    student = std::move(decoded);
+    if (!columns.has_scores()) return true;
+    std::string scores_str = line.substr(starts.back());
+    
+    // 解析成绩信息（如果存在）
+    if (scores_str != "无成绩" && !scores_str.empty()) {
+        std::istringstream scores_stream(scores_str);
+        std::string subject_score;
+        
+        while (std::getline(scores_stream, subject_score, ';')) {
+            size_t colon_pos = subject_score.find(':');
+            if (colon_pos != std::string::npos) {
+                std::string subject = subject_score.substr(0, colon_pos);
+                std::string score_str = subject_score.substr(colon_pos + 1);
+                
+                try {
+                    float score = std::stof(score_str);
+                    student.set_score(subject, score);
+                } catch (const std::invalid_argument& e) {
+                    if (skipped_scores) skipped_scores->push_back(subject + "=" + score_str);
+                } catch (const std::out_of_range&) {
+                    // 超出float范围的成绩（如1e999）与超出0-100的成绩一样使整行验证失败
+                    throw std::invalid_argument("成绩必须在0-100之间");
+                }
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,289 @@
+#include "frozen_roster.hh"
+#include "csv_codec.hh"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <unordered_set>
+
+namespace {
+
+constexpr char MAGIC[8] = {'S', 'M', 'S', 'F', 'R', 'Z', '1', '\0'};  ///< 文件标识
+constexpr int MAX_SEEDS = 16;  ///< 构造失败时最多更换的种子数
+
+/**
+ * @brief 64位整数混合函数
+ * @param h 输入
+ * @return uint64_t 混合后的值
+ */
+uint64_t mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+/**
+ * @brief 将偏移向上对齐到8字节
+ * @param offset 偏移
+ * @return uint64_t 对齐后的偏移
+ */
+uint64_t align8(uint64_t offset) {
+    return (offset + 7) & ~static_cast<uint64_t>(7);
+}
+
+} // namespace
+
+FrozenRoster::~FrozenRoster() {
+    close();
+}
+
+uint64_t FrozenRoster::key_hash(const StudentId& key, uint64_t seed) {
+    return mix(StudentIdHash()(key) ^ (seed * 0x9e3779b97f4a7c15ULL));
+}
+
+uint32_t FrozenRoster::slot_of(uint64_t hash, uint32_t displacement, uint32_t count) {
+    return static_cast<uint32_t>(mix(hash ^ ((displacement + 1ULL) * 0x9e3779b97f4a7c15ULL)) % count);
+}
+
+bool FrozenRoster::write(const std::list<Student>& students, const std::string& filename) {
+    if (students.size() > UINT32_MAX) return false;
+    
+    std::vector<const Student*> items;
+    std::unordered_set<StudentId, StudentIdHash> seen;
+    items.reserve(students.size());
+    for (const auto& student : students) {
+        if (!seen.insert(student.get_id_key()).second) return false;
+        items.push_back(&student);
+    }
+    
+    uint32_t count = static_cast<uint32_t>(items.size());
+    uint32_t bucket_count = std::max<uint32_t>(1, (count + 3) / 4);
+    std::vector<uint32_t> displacements(bucket_count, 0);
+    std::vector<uint32_t> slot_of_item(count);
+    uint64_t seed = 0;
+    bool built = count == 0;
+    
+    // 哈希-位移构造：先处理大桶，为每个桶寻找使桶内学号全部落在空槽的位移值
+    for (int attempt = 0; attempt < MAX_SEEDS && !built; ++attempt) {
+        seed = static_cast<uint64_t>(attempt);
+        std::vector<uint64_t> hashes(count);
+        std::vector<std::vector<uint32_t>> buckets(bucket_count);
+        for (uint32_t i = 0; i < count; ++i) {
+            hashes[i] = key_hash(items[i]->get_id_key(), seed);
+            buckets[(hashes[i] >> 32) % bucket_count].push_back(i);
+        }
+        
+        std::vector<uint32_t> order(bucket_count);
+        for (uint32_t b = 0; b < bucket_count; ++b) order[b] = b;
+        std::stable_sort(order.begin(), order.end(), [&buckets](uint32_t a, uint32_t b) {
+            return buckets[a].size() > buckets[b].size();
+        });
+        
+        std::vector<bool> taken(count, false);
+        std::vector<uint32_t> slots;
+        uint64_t max_tries = std::max<uint64_t>(1u << 20, 32ULL * count);
+        built = true;
+        for (uint32_t b : order) {
+            const auto& bucket = buckets[b];
+            if (bucket.empty()) break;
+            
+            bool placed = false;
+            for (uint64_t d = 0; d < max_tries && !placed; ++d) {
+                slots.clear();
+                placed = true;
+                for (uint32_t i : bucket) {
+                    uint32_t slot = slot_of(hashes[i], static_cast<uint32_t>(d), count);
+                    if (taken[slot] || std::find(slots.begin(), slots.end(), slot) != slots.end()) {
+                        placed = false;
+                        break;
+                    }
+                    slots.push_back(slot);
+                }
+                if (placed) {
+                    displacements[b] = static_cast<uint32_t>(d);
+                    for (size_t k = 0; k < bucket.size(); ++k) {
+                        taken[slots[k]] = true;
+                        slot_of_item[bucket[k]] = slots[k];
+                    }
+                }
+            }
+            if (!placed) {
+                built = false;
+                break;
+            }
+        }
+    }
+    if (!built) return false;
+    
+    // 按槽位排列记录，字符串集中存放在字符串区
+    std::vector<Record> records(count);
+    std::vector<const Student*> by_slot(count);
+    std::string strings;
+    auto append = [&strings](const std::string& value, uint32_t ref[2]) {
+        ref[0] = static_cast<uint32_t>(strings.size());
+        ref[1] = static_cast<uint32_t>(value.size());
+        strings += value;
+    };
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t slot = slot_of_item[i];
+        const Student& student = *items[i];
+        Record& rec = records[slot];
+        std::memset(&rec, 0, sizeof(rec));
+        rec.id_low = student.get_id_key().low;
+        rec.id_high = student.get_id_key().high;
+        rec.id_length = student.get_id_key().length;
+        append(student.get_name(), rec.name);
+        append(student.get_class_id(), rec.class_id);
+        append(student_to_csv(student), rec.row);
+        by_slot[slot] = &student;
+    }
+    if (strings.size() > UINT32_MAX) return false;
+    
+    auto sorted_index = [&by_slot, count](const std::string& (Student::*field)() const) {
+        std::vector<uint32_t> index(count);
+        for (uint32_t i = 0; i < count; ++i) index[i] = i;
+        std::sort(index.begin(), index.end(), [&by_slot, field](uint32_t a, uint32_t b) {
+            const std::string& va = (by_slot[a]->*field)();
+            const std::string& vb = (by_slot[b]->*field)();
+            if (va != vb) return va < vb;
+            return by_slot[a]->get_id_key() < by_slot[b]->get_id_key();
+        });
+        return index;
+    };
+    std::vector<uint32_t> name_index = sorted_index(&Student::get_name);
+    std::vector<uint32_t> class_index = sorted_index(&Student::get_class_id);
+    
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.count = count;
+    header.bucket_count = bucket_count;
+    header.seed = seed;
+    header.buckets_offset = align8(sizeof(Header));
+    header.records_offset = align8(header.buckets_offset + bucket_count * sizeof(uint32_t));
+    header.name_index_offset = header.records_offset + static_cast<uint64_t>(count) * sizeof(Record);
+    header.class_index_offset = header.name_index_offset + count * sizeof(uint32_t);
+    header.strings_offset = header.class_index_offset + count * sizeof(uint32_t);
+    header.file_size = header.strings_offset + strings.size();
+    
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+    
+    auto pad_to = [&file](uint64_t offset) {
+        static const char zeros[8] = {0};
+        uint64_t position = static_cast<uint64_t>(file.tellp());
+        if (offset > position) file.write(zeros, static_cast<std::streamsize>(offset - position));
+    };
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    pad_to(header.buckets_offset);
+    file.write(reinterpret_cast<const char*>(displacements.data()), bucket_count * sizeof(uint32_t));
+    pad_to(header.records_offset);
+    file.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(count * sizeof(Record)));
+    file.write(reinterpret_cast<const char*>(name_index.data()), count * sizeof(uint32_t));
+    file.write(reinterpret_cast<const char*>(class_index.data()), count * sizeof(uint32_t));
+    file.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+    return file.good();
+}
+
+bool FrozenRoster::open(const std::string& filename) {
+    close();
+    if (!file_.open(filename, sizeof(Header))) return false;
+    
+    const char* data = file_.data();
+    size_t size = file_.size();
+    const Header& h = *reinterpret_cast<const Header*>(data);
+    bool valid = std::memcmp(h.magic, MAGIC, sizeof(MAGIC)) == 0 && h.file_size == size &&
+                 h.bucket_count > 0 && h.buckets_offset + h.bucket_count * sizeof(uint32_t) <= h.records_offset &&
+                 h.records_offset + static_cast<uint64_t>(h.count) * sizeof(Record) == h.name_index_offset &&
+                 h.name_index_offset + h.count * sizeof(uint32_t) == h.class_index_offset &&
+                 h.class_index_offset + h.count * sizeof(uint32_t) == h.strings_offset &&
+                 h.strings_offset <= size;
+    if (!valid) {
+        file_.close();
+        return false;
+    }
+    data_ = data;
+    return true;
+}
+
+void FrozenRoster::close() {
+    file_.close();
+    data_ = nullptr;
+}
+
+size_t FrozenRoster::size() const {
+    return data_ ? header().count : 0;
+}
+
+const FrozenRoster::Record& FrozenRoster::record(size_t slot) const {
+    return reinterpret_cast<const Record*>(data_ + header().records_offset)[slot];
+}
+
+std::string FrozenRoster::text(const uint32_t ref[2]) const {
+    return std::string(data_ + header().strings_offset + ref[0], ref[1]);
+}
+
+long FrozenRoster::find_slot(const StudentId& key) const {
+    if (!data_ || header().count == 0) return -1;
+    
+    const Header& h = header();
+    uint64_t hash = key_hash(key, h.seed);
+    const uint32_t* displacements = reinterpret_cast<const uint32_t*>(data_ + h.buckets_offset);
+    uint32_t slot = slot_of(hash, displacements[(hash >> 32) % h.bucket_count], h.count);
+    
+    // 完美哈希对不存在的学号也会给出某个槽位，需比对学号
+    const Record& rec = record(slot);
+    if (rec.id_low != key.low || rec.id_high != key.high || rec.id_length != key.length) return -1;
+    return static_cast<long>(slot);
+}
+
+Student FrozenRoster::get(size_t slot) const {
+    Student student;
+    student_from_csv(text(record(slot).row), student);
+    return student;
+}
+
+bool FrozenRoster::find_student_by_id(const std::string& student_id, Student& student) const {
+    StudentId key;
+    if (!StudentId::parse(student_id, key)) return false;
+    
+    long slot = find_slot(key);
+    if (slot < 0) return false;
+    student = get(static_cast<size_t>(slot));
+    return true;
+}
+
+std::vector<Student> FrozenRoster::equal_range(uint64_t index_offset, uint32_t (Record::*field)[2],
+                                               const std::string& value) const {
+    std::vector<Student> result;
+    if (!data_) return result;
+    
+    const uint32_t* begin = reinterpret_cast<const uint32_t*>(data_ + index_offset);
+    const uint32_t* end = begin + header().count;
+    const char* strings = data_ + header().strings_offset;
+    auto value_of = [this, field, strings](uint32_t slot) {
+        const uint32_t* ref = record(slot).*field;
+        return std::string_view(strings + ref[0], ref[1]);
+    };
+    
+    std::string_view target(value);
+    const uint32_t* first = std::lower_bound(begin, end, target,
+        [&value_of](uint32_t slot, std::string_view v) { return value_of(slot) < v; });
+    const uint32_t* last = std::upper_bound(first, end, target,
+        [&value_of](std::string_view v, uint32_t slot) { return v < value_of(slot); });
+    for (const uint32_t* it = first; it != last; ++it) {
+        result.push_back(get(*it));
+    }
+    return result;
+}
+
+std::vector<Student> FrozenRoster::find_students_by_name(const std::string& name) const {
+    return data_ ? equal_range(header().name_index_offset, &Record::name, name) : std::vector<Student>();
+}
+
+std::vector<Student> FrozenRoster::find_students_by_class(const std::string& class_id) const {
+    return data_ ? equal_range(header().class_index_offset, &Record::class_id, class_id) : std::vector<Student>();
+}
@@ -0,0 +1,160 @@
+#include "index_file.hh"
+#include "async_file.hh"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+constexpr char MAGIC[8] = {'S', 'M', 'S', 'I', 'D', 'X', '1', '\0'};  ///< 文件标识
+
+/**
+ * @brief 将偏移向上对齐到8字节
+ * @param offset 偏移
+ * @return uint64_t 对齐后的偏移
+ */
+uint64_t align8(uint64_t offset) {
+    return (offset + 7) & ~static_cast<uint64_t>(7);
+}
+
+/**
+ * @brief 将一段数据并入校验和（每次处理8字节，末尾不足8字节的部分补零）
+ * @param h 当前状态
+ * @param data 数据
+ * @param length 数据长度
+ * @return uint64_t 新状态
+ */
+uint64_t hash_words(uint64_t h, const char* data, size_t length) {
+    for (size_t i = 0; i < length; i += 8) {
+        uint64_t word = 0;
+        std::memcpy(&word, data + i, std::min<size_t>(8, length - i));
+        h = (((h << 5) | (h >> 59)) ^ word) * 0x9e3779b97f4a7c15ULL;
+    }
+    return h;
+}
+
+/**
+ * @brief 结束校验和计算
+ * @param h 当前状态
+ * @param size 数据总长度
+ * @return uint64_t 校验和
+ */
+uint64_t hash_finish(uint64_t h, uint64_t size) {
+    h ^= size;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+}
+
+constexpr uint64_t HASH_SEED = 0x243f6a8885a308d3ULL;  ///< 校验和初始状态
+
+} // namespace
+
+bool IndexFile::checksum_file(const std::string& filename, uint64_t& checksum, uint64_t& size) {
+    FileReader file;
+    if (!file.open(filename)) return false;
+    
+    // 除最后一块外块长都是CHUNK_SIZE（8的倍数），逐块并入与整体计算结果相同
+    uint64_t h = HASH_SEED;
+    size = 0;
+    const char* chunk = nullptr;
+    size_t length = 0;
+    while (file.next(chunk, length)) {
+        size += length;
+        h = hash_words(h, chunk, length);
+    }
+    checksum = hash_finish(h, size);
+    return !file.failed();
+}
+
+bool IndexFile::write(const std::string& filename, uint64_t data_checksum, uint64_t data_size,
+                      uint64_t record_count, const std::vector<std::pair<uint32_t, std::string>>& sections) {
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.data_size = data_size;
+    header.data_checksum = data_checksum;
+    header.record_count = record_count;
+    header.section_count = sections.size();
+    
+    std::vector<SectionEntry> entries(sections.size());
+    uint64_t offset = sizeof(Header) + sections.size() * sizeof(SectionEntry);
+    for (size_t i = 0; i < sections.size(); ++i) {
+        offset = align8(offset);
+        entries[i].id = sections[i].first;
+        entries[i].padding = 0;
+        entries[i].offset = offset;
+        entries[i].length = sections[i].second.size();
+        offset += entries[i].length;
+    }
+    header.file_size = offset;
+    
+    // 索引自身的校验和覆盖段表和各段数据（含对齐填充）
+    std::string body(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(SectionEntry));
+    for (size_t i = 0; i < sections.size(); ++i) {
+        body.resize(entries[i].offset - sizeof(Header), '\0');
+        body += sections[i].second;
+    }
+    header.index_checksum = hash_finish(hash_words(HASH_SEED, body.data(), body.size()), body.size());
+    
+    std::string temp = filename + ".tmp";
+    {
+        FileWriter file;
+        if (!file.open(temp)) return false;
+        
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(body);
+        if (!file.close()) {
+            std::remove(temp.c_str());
+            return false;
+        }
+    }
+    
+    std::remove(filename.c_str());
+    return std::rename(temp.c_str(), filename.c_str()) == 0;
+}
+
+bool IndexFile::open(const std::string& filename) {
+    close();
+    if (!file_.open(filename, sizeof(Header))) return false;
+    
+    const Header& h = header();
+    size_t body_size = file_.size() - sizeof(Header);
+    bool valid = std::memcmp(h.magic, MAGIC, sizeof(MAGIC)) == 0 && h.file_size == file_.size() &&
+                 h.section_count <= body_size / sizeof(SectionEntry) &&
+                 h.index_checksum == hash_finish(hash_words(HASH_SEED, file_.data() + sizeof(Header), body_size), body_size);
+    const SectionEntry* entries = reinterpret_cast<const SectionEntry*>(file_.data() + sizeof(Header));
+    for (uint64_t i = 0; valid && i < h.section_count; ++i) {
+        valid = entries[i].offset <= file_.size() && entries[i].length <= file_.size() - entries[i].offset;
+    }
+    if (!valid) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void IndexFile::close() {
+    file_.close();
+}
+
+bool IndexFile::matches(uint64_t data_checksum, uint64_t data_size, uint64_t record_count) const {
+    if (!is_open()) return false;
+    const Header& h = header();
+    return h.data_checksum == data_checksum && h.data_size == data_size && h.record_count == record_count;
+}
+
+bool IndexFile::section(uint32_t id, const char*& data, size_t& size) const {
+    if (!is_open()) return false;
+    
+    const SectionEntry* entries = reinterpret_cast<const SectionEntry*>(file_.data() + sizeof(Header));
+    for (uint64_t i = 0; i < header().section_count; ++i) {
+        if (entries[i].id == id) {
+            data = file_.data() + entries[i].offset;
+            size = static_cast<size_t>(entries[i].length);
+            return true;
+        }
+    }
+    return false;
+}
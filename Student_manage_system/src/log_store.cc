@@ -0,0 +1,450 @@
+#include "log_store.hh"
+#include "async_file.hh"
+#include "binary_io.hh"
+#include "crc32c.hh"
+#include "mapped_file.hh"
+#include "student_schema.hh"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+namespace {
+
+constexpr uint8_t RECORD_PUT = 1;    ///< 学生的最新版本
+constexpr uint8_t RECORD_ERASE = 2;  ///< 删除标记
+constexpr uint8_t RECORD_CLEAR = 3;  ///< 清空标记
+
+/**
+ * @struct Record
+ * @brief 解码后的一条记录
+ */
+struct Record {
+    uint8_t type = 0;     ///< 记录类型
+    std::string id;       ///< 学号文本
+    std::string data;     ///< 学生二进制记录
+    uint64_t offset = 0;  ///< 记录在段文件中的偏移
+    uint32_t length = 0;  ///< 记录长度
+};
+
+/**
+ * @brief 编码一条记录
+ * @param type 记录类型
+ * @param id 学号文本
+ * @param data 学生二进制记录
+ * @return std::string 记录字节（末尾带CRC32C）
+ */
+std::string encode_record(uint8_t type, const std::string& id, const std::string& data) {
+    std::string out;
+    write_pod(out, type);
+    write_string(out, id);
+    write_string(out, data);
+    write_pod(out, crc32c(out.data(), out.size()));
+    return out;
+}
+
+/**
+ * @brief 依次解码段文件中的记录
+ * @param data 文件内容
+ * @param size 文件长度
+ * @param visit 对每条记录调用，返回false时停止
+ * @return size_t 已接受记录的总长度，小于size表示后面的数据不完整、校验失败、无效或被visit拒绝
+ */
+template<typename F>
+size_t scan_records(const char* data, size_t size, F visit) {
+    BinaryReader reader(data, size);
+    Record record;
+    uint32_t crc = 0;
+    size_t end = 0;
+    while (end < size) {
+        if (!reader.read(record.type) || !reader.read_string(record.id) || !reader.read_string(record.data)) break;
+        uint32_t expected = crc32c(data + end, reader.offset() - end);
+        if (!reader.read(crc) || crc != expected || record.type < RECORD_PUT || record.type > RECORD_CLEAR) break;
+        record.offset = end;
+        record.length = static_cast<uint32_t>(reader.offset() - end);
+        if (!visit(record)) break;
+        end = reader.offset();
+    }
+    return end;
+}
+
+} // namespace
+
+LogStore::~LogStore() {
+    close();
+}
+
+bool LogStore::open(const std::string& directory) {
+    namespace fs = std::filesystem;
+    close();
+    
+    std::error_code error;
+    fs::create_directories(directory, error);
+    if (!fs::is_directory(directory, error)) return false;
+    
+    // 收集段文件，整理中途留下的临时文件直接删除
+    std::map<uint32_t, std::string> logs;
+    std::vector<uint32_t> bases;
+    for (const auto& item : fs::directory_iterator(directory, error)) {
+        const fs::path& path = item.path();
+        if (path.extension() == ".tmp") {
+            fs::remove(path, error);
+            continue;
+        }
+        std::string stem = path.stem().string();
+        if (stem.size() != 8 || stem.find_first_not_of("0123456789") != std::string::npos) continue;
+        uint32_t id = static_cast<uint32_t>(std::stoul(stem));
+        if (path.extension() == ".log") {
+            logs[id] = path.string();
+        } else if (path.extension() == ".base") {
+            bases.push_back(id);
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    directory_ = directory;
+    index_.clear();
+    segments_.clear();
+    compactions_ = 0;
+    compacted_bytes_ = 0;
+    failed_compaction_ = 0;
+    stopping_ = false;
+    
+    // 编号不大于最新基础段的文件已被它替代（整理完成后、删除旧文件前中断时会留下）
+    if (!bases.empty()) {
+        uint32_t base = *std::max_element(bases.begin(), bases.end());
+        for (uint32_t id : bases) {
+            if (id != base) fs::remove(segment_path(id, true), error);
+        }
+        while (!logs.empty() && logs.begin()->first <= base) {
+            fs::remove(logs.begin()->second, error);
+            logs.erase(logs.begin());
+        }
+        segments_[base].path = segment_path(base, true);
+    }
+    for (const auto& [id, path] : logs) segments_[id].path = path;
+    
+    auto fail = [this]() {
+        directory_.clear();
+        index_.clear();
+        segments_.clear();
+        return false;
+    };
+    
+    for (auto it = segments_.begin(); it != segments_.end(); ++it) {
+        Segment& segment = it->second;
+        uint64_t size = fs::file_size(segment.path, error);
+        if (error) return fail();
+        
+        MappedFile file;
+        if (size > 0 && !file.open(segment.path)) return fail();
+        uint32_t id = it->first;
+        size_t end = scan_records(file.data(), file.size(), [this, id](const Record& record) {
+            StudentId key;
+            if (record.type != RECORD_CLEAR && !StudentId::parse(record.id, key)) return false;
+            apply(record.type, key, {id, record.length, record.offset});
+            return true;
+        });
+        file.close();
+        
+        if (end < size) {
+            // 只有最后一个日志段的末尾允许不完整（写入中途崩溃），其余情况视为损坏
+            if (std::next(it) != segments_.end() || segment.path.compare(segment.path.size() - 4, 4, ".log") != 0) {
+                return fail();
+            }
+            fs::resize_file(segment.path, end, error);
+            if (error) return fail();
+            size = end;
+        }
+        segment.bytes = size;
+    }
+    
+    // 最后一个日志段继续作为活动段，否则开启新段
+    if (segments_.empty() || segments_.rbegin()->second.path != segment_path(segments_.rbegin()->first, false)) {
+        active_id_ = segments_.empty() ? 1 : segments_.rbegin()->first + 1;
+        segments_[active_id_].path = segment_path(active_id_, false);
+    } else {
+        active_id_ = segments_.rbegin()->first;
+    }
+    active_.open(segments_[active_id_].path, std::ios::binary | std::ios::app);
+    if (!active_.is_open()) return fail();
+    
+    sealed_bytes_ = 0;
+    sealed_dead_ = 0;
+    for (const auto& [id, segment] : segments_) {
+        if (id == active_id_) continue;
+        sealed_bytes_ += segment.bytes;
+        sealed_dead_ += segment.dead;
+    }
+    
+    compactor_ = std::thread([this]() {
+        std::unique_lock<std::mutex> wait_lock(mutex_);
+        while (true) {
+            wake_.wait(wait_lock, [this]() { return stopping_ || should_compact(); });
+            if (stopping_) return;
+            wait_lock.unlock();
+            compact();
+            wait_lock.lock();
+        }
+    });
+    return true;
+}
+
+void LogStore::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    if (compactor_.joinable()) compactor_.join();
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    active_.close();
+    directory_.clear();
+    index_.clear();
+    segments_.clear();
+}
+
+bool LogStore::put(const Student& student) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string data;
+    append_student_binary(data, student);
+    return append(RECORD_PUT, student.get_id_key(), student.get_id(), data);
+}
+
+bool LogStore::erase(const StudentId& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return append(RECORD_ERASE, key, key.to_string(), "");
+}
+
+bool LogStore::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return append(RECORD_CLEAR, StudentId(), "", "");
+}
+
+void LogStore::begin_batch() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++batch_depth_;
+}
+
+void LogStore::end_batch() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--batch_depth_ == 0 && active_.is_open()) active_.flush();
+}
+
+bool LogStore::for_each_live(const std::function<void(const std::string& data)>& visit) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (active_.is_open()) active_.flush();
+    
+    for (const auto& [id, segment] : segments_) {
+        if (segment.bytes == 0) continue;
+        MappedFile file;
+        if (!file.open(segment.path) || file.size() < segment.bytes) return false;
+        
+        uint32_t segment_id = id;
+        scan_records(file.data(), segment.bytes, [&](const Record& record) {
+            StudentId key;
+            if (record.type != RECORD_PUT || !StudentId::parse(record.id, key)) return true;
+            const Location* latest = index_.find(key);
+            if (latest && *latest == Location{segment_id, record.length, record.offset}) visit(record.data);
+            return true;
+        });
+    }
+    return true;
+}
+
+bool LogStore::compact() {
+    std::lock_guard<std::mutex> serial(compact_mutex_);
+    
+    // 整理全部封存段；它们不会再被写入，读取时不必持有mutex_
+    std::vector<std::pair<uint32_t, std::string>> inputs;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!active_.is_open()) return false;
+        for (const auto& [id, segment] : segments_) {
+            if (id != active_id_) inputs.emplace_back(id, segment.path);
+        }
+    }
+    if (inputs.empty()) return true;
+    
+    auto fail = [this]() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        failed_compaction_ = active_id_;
+        return false;
+    };
+    
+    // 可能仍有效的记录
+    struct Candidate {
+        StudentId key;     ///< 数值学号
+        Location from;     ///< 原位置
+        const char* data;  ///< 记录字节（在映射的段文件中）
+    };
+    std::vector<std::unique_ptr<MappedFile>> files;
+    std::vector<Candidate> candidates;
+    for (const auto& [id, path] : inputs) {
+        std::error_code error;
+        if (std::filesystem::file_size(path, error) == 0 || error) continue;
+        files.push_back(std::make_unique<MappedFile>());
+        const MappedFile& file = *files.back();
+        if (!files.back()->open(path)) return fail();
+        
+        uint32_t segment_id = id;
+        scan_records(file.data(), file.size(), [&](const Record& record) {
+            StudentId key;
+            if (record.type == RECORD_PUT && StudentId::parse(record.id, key)) {
+                candidates.push_back({key, {segment_id, record.length, record.offset}, file.data() + record.offset});
+            }
+            return true;
+        });
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [this](const Candidate& candidate) {
+            const Location* latest = index_.find(candidate.key);
+            return !latest || !(*latest == candidate.from);
+        }), candidates.end());
+    }
+    
+    // 有效记录原样复制到新的基础段，编号取最后一个输入段
+    uint32_t target = inputs.back().first;
+    std::string path = segment_path(target, true);
+    std::string temp = path + ".tmp";
+    std::vector<Location> moved;
+    moved.reserve(candidates.size());
+    uint64_t written = 0;
+    FileWriter writer;
+    if (!writer.open(temp)) return fail();
+    for (const auto& candidate : candidates) {
+        writer.write(candidate.data, candidate.from.length);
+        moved.push_back({target, candidate.from.length, written});
+        written += candidate.from.length;
+    }
+    if (!writer.close()) {
+        std::remove(temp.c_str());
+        return fail();
+    }
+    files.clear();
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::error_code error;
+        std::filesystem::rename(temp, path, error);
+        if (error) {
+            std::remove(temp.c_str());
+            failed_compaction_ = active_id_;
+            return false;
+        }
+        
+        // 整理期间又被覆盖或删除的记录不再指向新段，计为失效
+        uint64_t dead = 0;
+        for (size_t i = 0; i < candidates.size(); ++i) {
+            Location* latest = index_.find(candidates[i].key);
+            if (latest && *latest == candidates[i].from) {
+                *latest = moved[i];
+            } else {
+                dead += moved[i].length;
+            }
+        }
+        for (const auto& input : inputs) {
+            const Segment& segment = segments_[input.first];
+            sealed_bytes_ -= segment.bytes;
+            sealed_dead_ -= segment.dead;
+            segments_.erase(input.first);
+        }
+        segments_[target] = {path, written, dead};
+        sealed_bytes_ += written;
+        sealed_dead_ += dead;
+        compactions_++;
+        compacted_bytes_ += written;
+        failed_compaction_ = 0;
+    }
+    
+    for (const auto& input : inputs) {
+        if (input.second != path) std::remove(input.second.c_str());
+    }
+    return true;
+}
+
+LogStoreStats LogStore::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    LogStoreStats stats;
+    stats.segments = segments_.size();
+    stats.live_records = index_.size();
+    for (const auto& [id, segment] : segments_) {
+        stats.total_bytes += segment.bytes;
+        stats.dead_bytes += segment.dead;
+    }
+    stats.compactions = compactions_;
+    stats.compacted_bytes = compacted_bytes_;
+    stats.compaction_failed = failed_compaction_ != 0;
+    return stats;
+}
+
+size_t LogStore::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return index_.size();
+}
+
+bool LogStore::append(uint8_t type, const StudentId& key, const std::string& id, const std::string& data) {
+    if (!active_.is_open()) return false;
+    
+    std::string record = encode_record(type, id, data);
+    Segment& segment = segments_[active_id_];
+    Location location{active_id_, static_cast<uint32_t>(record.size()), segment.bytes};
+    active_.write(record.data(), static_cast<std::streamsize>(record.size()));
+    if (batch_depth_ == 0) active_.flush();
+    if (!active_) return false;
+    
+    segment.bytes += record.size();
+    apply(type, key, location);
+    if (segment.bytes >= SEGMENT_SIZE && !roll()) return false;
+    if (should_compact()) wake_.notify_one();
+    return true;
+}
+
+void LogStore::apply(uint8_t type, const StudentId& key, const Location& location) {
+    if (type == RECORD_CLEAR) {
+        index_.for_each([this](const StudentId&, const Location& old) { add_dead(old.segment, old.length); });
+        index_.clear();
+        add_dead(location.segment, location.length);
+        return;
+    }
+    
+    if (const Location* old = index_.find(key)) add_dead(old->segment, old->length);
+    if (type == RECORD_PUT) {
+        index_.insert_or_assign(key, location);
+    } else {
+        // 删除标记本身也是失效数据，整理时与被删除的记录一起丢弃
+        index_.erase(key);
+        add_dead(location.segment, location.length);
+    }
+}
+
+void LogStore::add_dead(uint32_t segment, uint64_t bytes) {
+    segments_[segment].dead += bytes;
+    if (segment != active_id_) sealed_dead_ += bytes;
+}
+
+bool LogStore::roll() {
+    active_.close();
+    const Segment& sealed = segments_[active_id_];
+    sealed_bytes_ += sealed.bytes;
+    sealed_dead_ += sealed.dead;
+    
+    ++active_id_;
+    segments_[active_id_].path = segment_path(active_id_, false);
+    active_.open(segments_[active_id_].path, std::ios::binary | std::ios::trunc);
+    return active_.is_open();
+}
+
+bool LogStore::should_compact() const {
+    return active_.is_open() && failed_compaction_ != active_id_ && sealed_bytes_ >= COMPACT_MIN_BYTES &&
+           sealed_dead_ * 100 >= sealed_bytes_ * COMPACT_DEAD_PERCENT;
+}
+
+std::string LogStore::segment_path(uint32_t id, bool base) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%08u.%s", static_cast<unsigned>(id), base ? "base" : "log");
+    return (std::filesystem::path(directory_) / name).string();
+}
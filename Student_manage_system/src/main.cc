@@ -1,13 +1,25 @@
 #include "system.hh"
+#include "replica.hh"
 #include <iostream>
+#include <limits>
+#include <sstream>
 #include <string>
+#include <vector>
+#ifdef _WIN32
 #include <windows.h>  // Windows API头文件
+#endif
+
+constexpr size_t PAGE_SIZE = 20;        ///< 详细列表每页显示的学生数
+constexpr size_t TABLE_PAGE_SIZE = 40;  ///< 表格列表每页显示的学生数
 
 /**
  * @brief 设置控制台为中文编码（UTF-8）
  * @return bool 设置成功返回true，失败返回false
+ * 
+ * 非Windows平台终端默认即为UTF-8，直接返回true。
  */
 bool set_console_chinese() {
+#ifdef _WIN32
     // 设置控制台输出代码页为UTF-8
     if (!SetConsoleOutputCP(CP_UTF8)) {
         std::cerr << "警告：无法设置控制台输出编码为UTF-8" << std::endl;
@@ -22,6 +34,7 @@ bool set_console_chinese() {
     
     // 设置控制台标题为中文（使用ANSI版本）
     SetConsoleTitleA("学生信息管理系统");
+#endif
     
     return true;
 }
@@ -36,6 +49,111 @@ void show_welcome_message() {
     std::cout << "系统初始化中..." << std::endl;
 }
 
+/**
+ * @brief 打印候选列表
+ * @param title 标题
+ * @param items 候选项
+ */
+void print_candidates(const std::string& title, const std::vector<std::string>& items) {
+    std::cout << title;
+    for (const auto& item : items) {
+        std::cout << " " << item;
+    }
+    std::cout << std::endl;
+}
+
+/**
+ * @brief 读取学号，输入以"*"结尾时列出以该前缀开头的学号并重新输入
+ * @param system 学生管理系统
+ * @param prompt 提示语
+ * @return std::string 用户输入的学号
+ */
+std::string read_student_id(const StudentManagementSystem& system, const std::string& prompt) {
+    while (true) {
+        std::cout << prompt << "（前缀加*可补全）: ";
+        std::string input;
+        std::getline(std::cin, input);
+        if (input.empty() || input.back() != '*') return input;
+        
+        input.pop_back();
+        auto ids = system.complete_student_id(input);
+        if (ids.empty()) {
+            std::cout << "[信息] 没有以 " << input << " 开头的学号" << std::endl;
+        } else {
+            print_candidates("[信息] 匹配的学号：", ids);
+        }
+    }
+}
+
+/**
+ * @brief 读取姓名，输入以"*"结尾时列出以该前缀开头的姓名并重新输入
+ * @param system 学生管理系统
+ * @param prompt 提示语
+ * @return std::string 用户输入的姓名
+ */
+std::string read_student_name(const StudentManagementSystem& system, const std::string& prompt) {
+    while (true) {
+        std::cout << prompt << "（前缀加*可补全）: ";
+        std::string input;
+        std::getline(std::cin, input);
+        if (input.empty() || input.back() != '*') return input;
+        
+        input.pop_back();
+        auto names = system.complete_student_name(input);
+        if (names.empty()) {
+            std::cout << "[信息] 没有以 " << input << " 开头的姓名" << std::endl;
+        } else {
+            print_candidates("[信息] 匹配的姓名：", names);
+        }
+    }
+}
+
+/**
+ * @brief 学号不存在时给出"您是不是要找"提示
+ * @param system 学生管理系统
+ * @param id 用户输入的学号
+ */
+void show_id_suggestions(const StudentManagementSystem& system, const std::string& id) {
+    auto ids = system.suggest_student_ids(id);
+    if (!ids.empty()) {
+        print_candidates("[提示] 您是不是要找：", ids);
+    }
+}
+
+/**
+ * @brief 姓名不存在时给出"您是不是要找"提示
+ * @param system 学生管理系统
+ * @param name 用户输入的姓名
+ */
+void show_name_suggestions(const StudentManagementSystem& system, const std::string& name) {
+    auto names = system.suggest_student_names(name);
+    if (!names.empty()) {
+        print_candidates("[提示] 您是不是要找：", names);
+    }
+}
+
+/**
+ * @brief 渲染并一次性输出一组学生，超过一页时改用表格形式
+ * @param students 学生列表
+ */
+void print_students(const std::vector<Student>& students) {
+    std::string buffer;
+    bool compact = students.size() > PAGE_SIZE;
+    if (compact) {
+        Student::format_table_header(buffer);
+    }
+    for (const auto& student : students) {
+        if (compact) {
+            student.format_row_into(buffer);
+        } else {
+            student.format_into(buffer);
+            buffer += "-------------------\n";
+        }
+    }
+    std::cout.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    std::cout.flush();
+}
+
 void show_menu() {
     std::cout << "\n=== 学生信息管理系统 ===" << std::endl;
     std::cout << "1. 添加学生" << std::endl;
@@ -43,25 +161,161 @@ void show_menu() {
     std::cout << "3. 删除学生（按姓名）" << std::endl;
     std::cout << "4. 查询学生（按学号）" << std::endl;
     std::cout << "5. 查询学生（按姓名）" << std::endl;
-    std::cout << "6. 显示所有学生" << std::endl;
+    std::cout << "6. 显示所有学生（分页）" << std::endl;
     std::cout << "7. 设置学生成绩" << std::endl;
     std::cout << "8. 查询学生成绩" << std::endl;
     std::cout << "9. 保存数据到Excel文件" << std::endl;
     std::cout << "10. 加载数据" << std::endl;
+    std::cout << "11. 增量导入数据" << std::endl;
+    std::cout << "12. 撤销上一步操作" << std::endl;
+    std::cout << "13. 重做" << std::endl;
+    std::cout << "14. 模糊搜索学生（拼音/容错）" << std::endl;
+    std::cout << "15. 冻结/解冻名册（只读）" << std::endl;
+    std::cout << "16. 按班级导出（每班一个文件）" << std::endl;
+    std::cout << "17. 合并加载多个文件" << std::endl;
+    std::cout << "18. 分段增量保存" << std::endl;
+    std::cout << "19. 打开日志结构存储" << std::endl;
+    std::cout << "20. 按列加载数据（只读统计用）" << std::endl;
     std::cout << "0. 退出系统" << std::endl;
     std::cout << "请选择操作: ";
 }
 
-int main() {
+void show_replica_menu() {
+    std::cout << "\n=== 只读副本 ===" << std::endl;
+    std::cout << "1. 查询学生（按学号）" << std::endl;
+    std::cout << "2. 查询学生（按姓名）" << std::endl;
+    std::cout << "3. 查询学生成绩" << std::endl;
+    std::cout << "4. 显示学生数量" << std::endl;
+    std::cout << "5. 显示复制延迟" << std::endl;
+    std::cout << "0. 退出副本" << std::endl;
+    std::cout << "请选择操作: ";
+}
+
+/**
+ * @brief 以只读副本模式运行
+ * @param log_filename 主实例写出的变更日志文件名
+ * @return int 进程退出码
+ */
+int run_replica(const std::string& log_filename) {
+    StudentReplica replica(log_filename);
+    replica.poll();
+    replica.start();
+    std::cout << "[信息] 只读副本已启动，追读变更日志：" << log_filename << std::endl;
+    
+    while (true) {
+        show_replica_menu();
+        int choice;
+        if (!(std::cin >> choice)) {
+            if (std::cin.eof()) return 0;
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            std::cout << "[警告] 输入无效，请输入数字选项！" << std::endl;
+            continue;
+        }
+        std::cin.ignore();
+        
+        switch (choice) {
+            case 0:
+                return 0;
+                
+            case 1: {
+                std::string id;
+                std::cout << "请输入要查询的学生学号: ";
+                std::getline(std::cin, id);
+                Student student;
+                if (replica.find_student_by_id(id, student)) {
+                    student.show_info();
+                } else {
+                    std::cout << "[失败] 学生不存在！" << std::endl;
+                }
+                break;
+            }
+                
+            case 2: {
+                std::string name;
+                std::cout << "请输入要查询的学生姓名: ";
+                std::getline(std::cin, name);
+                auto students = replica.find_students_by_name(name);
+                if (students.empty()) {
+                    std::cout << "[失败] 未找到匹配的学生！" << std::endl;
+                } else {
+                    std::cout << "[成功] 找到 " << students.size() << " 个匹配的学生：" << std::endl;
+                    print_students(students);
+                }
+                break;
+            }
+                
+            case 3: {
+                std::string id;
+                std::cout << "请输入学生学号: ";
+                std::getline(std::cin, id);
+                std::cout << "=== 学生成绩信息 ===" << std::endl;
+                std::cout << replica.get_student_scores_info(id) << std::endl;
+                break;
+            }
+                
+            case 4:
+                std::cout << "副本学生数量：" << replica.get_student_count() << std::endl;
+                break;
+                
+            case 5: {
+                ReplicaLag lag = replica.lag();
+                std::cout << "已应用序列号：" << lag.applied_sequence << std::endl;
+                std::cout << "已应用事件数：" << lag.applied_events << std::endl;
+                std::cout << "跳过事件数：" << lag.skipped_events << std::endl;
+                std::cout << "待读取字节数：" << lag.pending_bytes << std::endl;
+                std::cout << "应用延迟(ms)：" << lag.apply_delay_ms << std::endl;
+                std::cout << "数据陈旧度(ms)：" << lag.staleness_ms << std::endl;
+                break;
+            }
+                
+            default:
+                std::cout << "[警告] 无效选择，请重新输入！" << std::endl;
+        }
+    }
+}
+
+/**
+ * @brief 程序入口
+ * 
+ * 命令行参数：
+ *   --changelog <文件>  主实例将所有变更追加写入该日志文件
+ *   --replica <文件>    以只读副本模式运行，追读该变更日志
+ *   --direct-io         加载和保存大文件时超过64MB的部分绕过页缓存
+ */
+int main(int argc, char* argv[]) {
     // 设置控制台中文编码
     if (!set_console_chinese()) {
         std::cout << "注意：控制台编码设置可能不完整，中文字符显示可能异常" << std::endl;
     }
     
+    std::string changelog;
+    bool direct_io = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--replica" && i + 1 < argc) {
+            return run_replica(argv[i + 1]);
+        } else if (arg == "--changelog" && i + 1 < argc) {
+            changelog = argv[++i];
+        } else if (arg == "--direct-io") {
+            direct_io = true;
+        }
+    }
+    
     // 显示欢迎信息
     show_welcome_message();
     
     StudentManagementSystem system;
+    system.set_direct_io(direct_io);
+    
+    // 先打开变更日志，使自动加载的数据也进入日志供副本重放
+    if (!changelog.empty()) {
+        if (system.change_stream().open_log(changelog)) {
+            std::cout << "[信息] 变更日志已开启：" << changelog << std::endl;
+        } else {
+            std::cout << "[警告] 无法打开变更日志：" << changelog << std::endl;
+        }
+    }
     
     // 尝试自动加载数据（添加异常处理）
     try {
@@ -127,14 +381,13 @@ int main() {
             }
                 
             case 2: {
-                std::string id;
-                std::cout << "请输入要删除的学生学号: ";
-                std::getline(std::cin, id);
+                std::string id = read_student_id(system, "请输入要删除的学生学号");
                 try {
                     if (system.delete_student(id)) {
                         std::cout << "[成功] 删除成功！" << std::endl;
                     } else {
                         std::cout << "[失败] 删除失败！" << std::endl;
+                        show_id_suggestions(system, id);
                     }
                 } catch (const std::exception& e) {
                     std::cout << "[失败] 删除学生时发生错误：" << e.what() << std::endl;
@@ -143,14 +396,13 @@ int main() {
             }
                 
             case 3: {
-                std::string name;
-                std::cout << "请输入要删除的学生姓名: ";
-                std::getline(std::cin, name);
+                std::string name = read_student_name(system, "请输入要删除的学生姓名");
                 try {
                     if (system.delete_student_by_name(name)) {
                         std::cout << "[成功] 删除成功！" << std::endl;
                     } else {
                         std::cout << "[失败] 删除失败！" << std::endl;
+                        show_name_suggestions(system, name);
                     }
                 } catch (const std::exception& e) {
                     std::cout << "[失败] 删除学生时发生错误：" << e.what() << std::endl;
@@ -159,15 +411,14 @@ int main() {
             }
                 
             case 4: {
-                std::string id;
-                std::cout << "请输入要查询的学生学号: ";
-                std::getline(std::cin, id);
+                std::string id = read_student_id(system, "请输入要查询的学生学号");
                 try {
-                    Student* student = system.find_student_by_id(id);
-                    if (student) {
-                        student->show_info();
+                    Student student;
+                    if (system.find_student_by_id(id, student)) {
+                        student.show_info();
                     } else {
                         std::cout << "[失败] 学生不存在！" << std::endl;
+                        show_id_suggestions(system, id);
                     }
                 } catch (const std::exception& e) {
                     std::cout << "[失败] 查询学生时发生错误：" << e.what() << std::endl;
@@ -176,19 +427,15 @@ int main() {
             }
                 
             case 5: {
-                std::string name;
-                std::cout << "请输入要查询的学生姓名: ";
-                std::getline(std::cin, name);
+                std::string name = read_student_name(system, "请输入要查询的学生姓名");
                 try {
                     auto students = system.find_students_by_name_exact(name);
                     if (students.empty()) {
                         std::cout << "[失败] 未找到匹配的学生！" << std::endl;
+                        show_name_suggestions(system, name);
                     } else {
                         std::cout << "[成功] 找到 " << students.size() << " 个匹配的学生：" << std::endl;
-                        for (auto* student : students) {
-                            student->show_info();
-                            std::cout << "-------------------" << std::endl;
-                        }
+                        print_students(students);
                     }
                 } catch (const std::exception& e) {
                     std::cout << "[失败] 查询学生时发生错误：" << e.what() << std::endl;
@@ -196,19 +443,48 @@ int main() {
                 break;
             }
                 
-            case 6:
+            case 6: {
+                std::cout << "排序方式（1-学号 2-姓名 3-班级 4-平均分，默认1）: ";
+                std::string order;
+                std::getline(std::cin, order);
+                StudentSortKey key = StudentSortKey::ID;
+                if (order == "2") key = StudentSortKey::NAME;
+                else if (order == "3") key = StudentSortKey::CLASS_ID;
+                else if (order == "4") key = StudentSortKey::AVERAGE_SCORE;
+                
+                std::cout << "显示方式（1-详细 2-表格，默认1）: ";
+                std::string mode;
+                std::getline(std::cin, mode);
+                bool compact = mode == "2";
+                
                 try {
-                    system.show_all_students();
+                    // 每页渲染为一段文本后一次写出
+                    std::string token;
+                    size_t shown = 0;
+                    while (true) {
+                        StudentPage page = system.list_students(compact ? TABLE_PAGE_SIZE : PAGE_SIZE, key, token);
+                        std::string text = StudentManagementSystem::render_page(page, shown + 1, compact);
+                        std::cout.write(text.data(), static_cast<std::streamsize>(text.size()));
+                        std::cout.flush();
+                        shown += page.students.size();
+                        if (page.next_token.empty()) break;
+                        
+                        std::cout << "还有 " << page.remaining << " 名学生，回车显示下一页，输入q返回: ";
+                        std::string input;
+                        std::getline(std::cin, input);
+                        if (input == "q" || input == "Q") break;
+                        token = page.next_token;
+                    }
                 } catch (const std::exception& e) {
                     std::cout << "[失败] 显示学生列表时发生错误：" << e.what() << std::endl;
                 }
                 break;
+            }
                 
             case 7: {
-                std::string id, subject;
+                std::string id = read_student_id(system, "请输入学生学号");
+                std::string subject;
                 float score;
-                std::cout << "请输入学生学号: ";
-                std::getline(std::cin, id);
                 std::cout << "请输入科目名称: ";
                 std::getline(std::cin, subject);
                 std::cout << "请输入成绩(0-100): ";
@@ -226,6 +502,7 @@ int main() {
                         std::cout << "[成功] 成绩设置成功！" << std::endl;
                     } else {
                         std::cout << "[失败] 成绩设置失败！" << std::endl;
+                        show_id_suggestions(system, id);
                     }
                 } catch (const std::exception& e) {
                     std::cout << "[失败] 设置成绩时发生错误：" << e.what() << std::endl;
@@ -234,24 +511,35 @@ int main() {
             }
                 
             case 8: {
-                std::string id;
-                std::cout << "请输入学生学号: ";
-                std::getline(std::cin, id);
+                std::string id = read_student_id(system, "请输入学生学号");
                 
                 try {
                     std::string scores_info = system.get_student_scores_info(id);
                     std::cout << "=== 学生成绩信息 ===" << std::endl;
                     std::cout << scores_info << std::endl;
+                    if (!system.has_student(id)) {
+                        show_id_suggestions(system, id);
+                    }
                 } catch (const std::exception& e) {
                     std::cout << "[失败] 查询成绩时发生错误：" << e.what() << std::endl;
                 }
                 break;
             }
                 
-            case 9:
+            case 9: {
+                std::string spec;
+                std::vector<SortKey> order;
+                std::cout << "请输入排序方式（如：班级,平均分降序,数学降序；直接回车按学号）: ";
+                std::getline(std::cin, spec);
+                if (!StudentManagementSystem::parse_sort_keys(spec, order)) {
+                    std::cout << "[失败] 排序方式格式不正确！" << std::endl;
+                    break;
+                }
+                
                 try {
-                    if (system.save_to_excel_file("students.csv")) {
-                        std::cout << "[成功] 保存成功！数据已按学号排序并保存为Excel格式。" << std::endl;
+                    if (system.save_to_excel_file("students.csv", order)) {
+                        std::cout << "[成功] 保存成功！数据已按" << (order.empty() ? "学号" : spec)
+                                  << "排序并保存为Excel格式。" << std::endl;
                     } else {
                         std::cout << "[失败] 保存失败！" << std::endl;
                     }
@@ -259,6 +547,7 @@ int main() {
                     std::cout << "[失败] 保存数据时发生错误：" << e.what() << std::endl;
                 }
                 break;
+            }
                 
             case 10:
                 try {
@@ -272,6 +561,183 @@ int main() {
                 }
                 break;
                 
+            case 11: {
+                std::string filename;
+                std::cout << "请输入增量文件名: ";
+                std::getline(std::cin, filename);
+                
+                try {
+                    ImportStats stats;
+                    if (system.upsert_from_file(filename, stats)) {
+                        std::cout << "[成功] 增量导入完成：新增 " << stats.inserted
+                                  << "，更新 " << stats.updated
+                                  << "，未变化 " << stats.unchanged
+                                  << "，删除 " << stats.deleted
+                                  << "，删除目标不存在 " << stats.not_found
+                                  << "，无效 " << stats.invalid << std::endl;
+                    } else {
+                        std::cout << "[失败] 增量导入失败！" << std::endl;
+                    }
+                } catch (const std::exception& e) {
+                    std::cout << "[失败] 增量导入时出错：" << e.what() << std::endl;
+                }
+                break;
+            }
+                
+            case 12:
+                if (system.undo()) {
+                    std::cout << "[成功] 已撤销上一步操作！" << std::endl;
+                } else {
+                    std::cout << "[失败] 没有可撤销的操作！" << std::endl;
+                }
+                break;
+                
+            case 13:
+                if (system.redo()) {
+                    std::cout << "[成功] 已重做！" << std::endl;
+                } else {
+                    std::cout << "[失败] 没有可重做的操作！" << std::endl;
+                }
+                break;
+                
+            case 14: {
+                std::string query;
+                std::cout << "请输入姓名、全拼或拼音首字母: ";
+                std::getline(std::cin, query);
+                
+                auto matches = system.search_students_by_name(query);
+                if (matches.empty()) {
+                    std::cout << "[失败] 未找到相近的学生！" << std::endl;
+                } else {
+                    std::cout << "[成功] 找到 " << matches.size() << " 个相近的学生：" << std::endl;
+                    for (const auto& match : matches) {
+                        std::cout << "学号: " << match.student_id << "  姓名: " << match.name
+                                  << "  距离: " << match.distance << std::endl;
+                    }
+                }
+                break;
+            }
+                
+            case 15:
+                if (system.is_frozen()) {
+                    system.unfreeze();
+                    std::cout << "[成功] 名册已解冻，可以继续修改！" << std::endl;
+                } else if (system.freeze("roster.frz")) {
+                    std::cout << "[成功] 名册已冻结为只读，冻结文件: roster.frz" << std::endl;
+                } else {
+                    std::cout << "[失败] 冻结名册失败！" << std::endl;
+                }
+                break;
+                
+            case 16: {
+                std::string output_dir;
+                std::cout << "请输入导出目录: ";
+                std::getline(std::cin, output_dir);
+                
+                size_t class_count = 0;
+                if (system.export_by_class(output_dir, class_count)) {
+                    std::cout << "[成功] 已导出 " << class_count << " 个班级文件到目录: " << output_dir << std::endl;
+                } else {
+                    std::cout << "[失败] 按班级导出失败，已写出 " << class_count << " 个班级文件！" << std::endl;
+                }
+                break;
+            }
+                
+            case 17: {
+                std::string input;
+                std::cout << "请输入文件名（多个文件用逗号分隔）: ";
+                std::getline(std::cin, input);
+                
+                std::vector<std::string> filenames;
+                std::istringstream names(input);
+                std::string filename;
+                while (std::getline(names, filename, ',')) {
+                    filename.erase(0, filename.find_first_not_of(' '));
+                    filename.erase(filename.find_last_not_of(' ') + 1);
+                    if (!filename.empty()) filenames.push_back(filename);
+                }
+                
+                LoadReport report;
+                if (system.load_from_files(filenames, report)) {
+                    std::cout << "[成功] 从 " << report.files_loaded << " 个文件加载了 " << report.loaded << " 个学生" << std::endl;
+                } else {
+                    std::cout << "[失败] 没有加载到任何学生！" << std::endl;
+                }
+                if (!report.issues.empty()) {
+                    std::cout << "无法加载 " << report.files_failed << " 个文件，跳过无效数据 " << report.invalid
+                              << " 行、重复学号 " << report.duplicates << " 行：" << std::endl;
+                    constexpr size_t MAX_SHOWN = 20;
+                    for (size_t i = 0; i < report.issues.size() && i < MAX_SHOWN; ++i) {
+                        const LoadIssue& issue = report.issues[i];
+                        std::cout << "  " << issue.filename;
+                        if (issue.line > 0) std::cout << " 第" << issue.line << "行";
+                        std::cout << "：" << issue.message << std::endl;
+                    }
+                    if (report.issues.size() > MAX_SHOWN) {
+                        std::cout << "  ……共 " << report.issues.size() << " 条" << std::endl;
+                    }
+                }
+                break;
+            }
+                
+            case 18: {
+                std::string filename;
+                std::cout << "请输入清单文件名（直接回车使用 students.manifest）: ";
+                std::getline(std::cin, filename);
+                if (filename.empty()) filename = "students.manifest";
+                
+                size_t rewritten = 0;
+                if (system.save_segments(filename, rewritten)) {
+                    std::cout << "[成功] 已保存到 " << filename << "，重写 " << rewritten << " 个分段" << std::endl;
+                } else {
+                    std::cout << "[失败] 分段保存失败，原有清单保持不变！" << std::endl;
+                }
+                break;
+            }
+                
+            case 19: {
+                std::string directory;
+                std::cout << "请输入存储目录（直接回车使用 students.lsm）: ";
+                std::getline(std::cin, directory);
+                if (directory.empty()) directory = "students.lsm";
+                
+                if (system.open_log_store(directory)) {
+                    LogStoreStats stats = system.log_store_stats();
+                    std::cout << "[成功] 已打开日志结构存储: " << directory << "，共 " << stats.live_records
+                              << " 个学生、" << stats.segments << " 个段文件，之后的修改会自动写入" << std::endl;
+                } else {
+                    std::cout << "[失败] 打开日志结构存储失败！" << std::endl;
+                }
+                break;
+            }
+                
+            case 20: {
+                std::string filename;
+                std::cout << "请输入文件名（直接回车使用 students.csv）: ";
+                std::getline(std::cin, filename);
+                if (filename.empty()) filename = "students.csv";
+                
+                std::string labels;
+                std::cout << "请输入要加载的列（逗号分隔，可选 " << ColumnSet::all().to_string()
+                          << "，直接回车使用 学号,班级,成绩信息）: ";
+                std::getline(std::cin, labels);
+                if (labels.empty()) labels = "学号,班级,成绩信息";
+                
+                ColumnSet columns;
+                if (!ColumnSet::parse(labels, columns)) {
+                    std::cout << "[失败] 无法识别的列名：" << labels << std::endl;
+                } else if (system.load_from_file(filename, columns)) {
+                    std::cout << "[成功] 已加载 " << system.get_student_count() << " 个学生的 "
+                              << columns.to_string() << " 列" << std::endl;
+                    if (!columns.is_all()) {
+                        std::cout << "未加载的列为空，重新加载全部列（菜单10）之前不能保存数据" << std::endl;
+                    }
+                } else {
+                    std::cout << "[失败] 加载失败！" << std::endl;
+                }
+                break;
+            }
+                
             default:
                 std::cout << "[警告] 无效选择，请重新输入！" << std::endl;
         }
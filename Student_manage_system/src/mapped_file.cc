@@ -0,0 +1,56 @@
+#include "mapped_file.hh"
+#include <fstream>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& filename, size_t min_size) {
+    close();
+
+#ifndef _WIN32
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0 || static_cast<size_t>(info.st_size) < min_size) {
+        ::close(fd);
+        return false;
+    }
+    void* address = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) return false;
+    data_ = static_cast<const char*>(address);
+    size_ = static_cast<size_t>(info.st_size);
+    mapped_ = true;
+#else
+    // 不支持mmap的平台整体读入内存
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return false;
+    std::streamsize length = file.tellg();
+    if (length <= 0 || static_cast<size_t>(length) < min_size) return false;
+    buffer_.resize(static_cast<size_t>(length));
+    file.seekg(0);
+    if (!file.read(buffer_.data(), length)) return false;
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+#endif
+    return true;
+}
+
+void MappedFile::close() {
+#ifndef _WIN32
+    if (mapped_ && data_) {
+        munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+    buffer_.clear();
+}
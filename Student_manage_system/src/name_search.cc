@@ -0,0 +1,365 @@
+#include "name_search.hh"
+#include "binary_io.hh"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <map>
+
+namespace {
+
+// 常用姓氏及名字用字的拼音（多音字取作姓名时的常见读音）
+const std::pair<const char*, const char*> kBuiltinPinyin[] = {
+    {"王", "wang"}, {"李", "li"}, {"张", "zhang"}, {"刘", "liu"}, {"陈", "chen"}, {"杨", "yang"},
+    {"黄", "huang"}, {"赵", "zhao"}, {"吴", "wu"}, {"周", "zhou"}, {"徐", "xu"}, {"孙", "sun"},
+    {"马", "ma"}, {"朱", "zhu"}, {"胡", "hu"}, {"郭", "guo"}, {"何", "he"}, {"高", "gao"}, {"林", "lin"},
+    {"罗", "luo"}, {"郑", "zheng"}, {"梁", "liang"}, {"谢", "xie"}, {"宋", "song"}, {"唐", "tang"},
+    {"许", "xu"}, {"韩", "han"}, {"冯", "feng"}, {"邓", "deng"}, {"曹", "cao"}, {"彭", "peng"},
+    {"曾", "zeng"}, {"肖", "xiao"}, {"田", "tian"}, {"董", "dong"}, {"袁", "yuan"}, {"潘", "pan"},
+    {"于", "yu"}, {"蒋", "jiang"}, {"蔡", "cai"}, {"余", "yu"}, {"杜", "du"}, {"叶", "ye"},
+    {"程", "cheng"}, {"苏", "su"}, {"魏", "wei"}, {"吕", "lv"}, {"丁", "ding"}, {"任", "ren"},
+    {"沈", "shen"}, {"姚", "yao"}, {"卢", "lu"}, {"姜", "jiang"}, {"崔", "cui"}, {"钟", "zhong"},
+    {"谭", "tan"}, {"陆", "lu"}, {"汪", "wang"}, {"范", "fan"}, {"金", "jin"}, {"石", "shi"},
+    {"廖", "liao"}, {"贾", "jia"}, {"夏", "xia"}, {"韦", "wei"}, {"付", "fu"}, {"方", "fang"},
+    {"白", "bai"}, {"邹", "zou"}, {"孟", "meng"}, {"熊", "xiong"}, {"秦", "qin"}, {"邱", "qiu"},
+    {"江", "jiang"}, {"尹", "yin"}, {"薛", "xue"}, {"闫", "yan"}, {"段", "duan"}, {"雷", "lei"},
+    {"侯", "hou"}, {"龙", "long"}, {"史", "shi"}, {"陶", "tao"}, {"黎", "li"}, {"贺", "he"}, {"顾", "gu"},
+    {"毛", "mao"}, {"郝", "hao"}, {"龚", "gong"}, {"邵", "shao"}, {"万", "wan"}, {"钱", "qian"},
+    {"严", "yan"}, {"覃", "qin"}, {"武", "wu"}, {"戴", "dai"}, {"莫", "mo"}, {"孔", "kong"},
+    {"向", "xiang"}, {"汤", "tang"}, {"常", "chang"}, {"温", "wen"}, {"康", "kang"}, {"施", "shi"},
+    {"文", "wen"}, {"牛", "niu"}, {"樊", "fan"}, {"葛", "ge"}, {"邢", "xing"}, {"安", "an"}, {"齐", "qi"},
+    {"易", "yi"}, {"乔", "qiao"}, {"伍", "wu"}, {"庞", "pang"}, {"颜", "yan"}, {"倪", "ni"},
+    {"庄", "zhuang"}, {"聂", "nie"}, {"章", "zhang"}, {"鲁", "lu"}, {"岳", "yue"}, {"翟", "zhai"},
+    {"殷", "yin"}, {"詹", "zhan"}, {"申", "shen"}, {"欧", "ou"}, {"耿", "geng"}, {"关", "guan"},
+    {"兰", "lan"}, {"焦", "jiao"}, {"俞", "yu"}, {"左", "zuo"}, {"柳", "liu"}, {"甘", "gan"},
+    {"祝", "zhu"}, {"包", "bao"}, {"宁", "ning"}, {"尚", "shang"}, {"符", "fu"}, {"舒", "shu"},
+    {"阮", "ruan"}, {"柯", "ke"}, {"纪", "ji"}, {"梅", "mei"}, {"童", "tong"}, {"凌", "ling"},
+    {"毕", "bi"}, {"单", "shan"}, {"季", "ji"}, {"裴", "pei"}, {"霍", "huo"}, {"涂", "tu"},
+    {"成", "cheng"}, {"苗", "miao"}, {"谷", "gu"}, {"盛", "sheng"}, {"曲", "qu"}, {"翁", "weng"},
+    {"冉", "ran"}, {"骆", "luo"}, {"蓝", "lan"}, {"路", "lu"}, {"游", "you"}, {"辛", "xin"},
+    {"靳", "jin"}, {"管", "guan"}, {"柴", "chai"}, {"蒙", "meng"}, {"鲍", "bao"}, {"华", "hua"},
+    {"喻", "yu"}, {"祁", "qi"}, {"蒲", "pu"}, {"房", "fang"}, {"滕", "teng"}, {"屈", "qu"}, {"饶", "rao"},
+    {"解", "xie"}, {"牟", "mou"}, {"艾", "ai"}, {"尤", "you"}, {"阳", "yang"}, {"时", "shi"},
+    {"穆", "mu"}, {"农", "nong"}, {"司", "si"}, {"卓", "zhuo"}, {"古", "gu"}, {"吉", "ji"},
+    {"缪", "miao"}, {"简", "jian"}, {"车", "che"}, {"项", "xiang"}, {"连", "lian"}, {"芦", "lu"},
+    {"麦", "mai"}, {"褚", "chu"}, {"娄", "lou"}, {"窦", "dou"}, {"戚", "qi"}, {"岑", "cen"},
+    {"景", "jing"}, {"党", "dang"}, {"宫", "gong"}, {"费", "fei"}, {"卜", "bu"}, {"冷", "leng"},
+    {"晏", "yan"}, {"席", "xi"}, {"卫", "wei"}, {"米", "mi"}, {"柏", "bai"}, {"宗", "zong"}, {"瞿", "qu"},
+    {"桂", "gui"}, {"全", "quan"}, {"佟", "tong"}, {"应", "ying"}, {"臧", "zang"}, {"闵", "min"},
+    {"苟", "gou"}, {"邬", "wu"}, {"边", "bian"}, {"卞", "bian"}, {"姬", "ji"}, {"师", "shi"},
+    {"和", "he"}, {"仇", "qiu"}, {"栾", "luan"}, {"隋", "sui"}, {"商", "shang"}, {"刁", "diao"},
+    {"沙", "sha"}, {"荣", "rong"}, {"巫", "wu"}, {"寇", "kou"}, {"桑", "sang"}, {"郎", "lang"},
+    {"甄", "zhen"}, {"丛", "cong"}, {"仲", "zhong"}, {"虞", "yu"}, {"敖", "ao"}, {"巩", "gong"},
+    {"明", "ming"}, {"佘", "she"}, {"池", "chi"}, {"查", "zha"}, {"麻", "ma"}, {"苑", "yuan"},
+    {"迟", "chi"}, {"邝", "kuang"}, {"官", "guan"}, {"封", "feng"}, {"谈", "tan"}, {"匡", "kuang"},
+    {"鞠", "ju"}, {"惠", "hui"}, {"荆", "jing"}, {"伟", "wei"}, {"芳", "fang"}, {"娜", "na"},
+    {"敏", "min"}, {"静", "jing"}, {"丽", "li"}, {"强", "qiang"}, {"磊", "lei"}, {"军", "jun"},
+    {"洋", "yang"}, {"勇", "yong"}, {"艳", "yan"}, {"杰", "jie"}, {"娟", "juan"}, {"涛", "tao"},
+    {"超", "chao"}, {"秀", "xiu"}, {"英", "ying"}, {"平", "ping"}, {"刚", "gang"}, {"玉", "yu"},
+    {"红", "hong"}, {"建", "jian"}, {"国", "guo"}, {"辉", "hui"}, {"鑫", "xin"}, {"宇", "yu"},
+    {"浩", "hao"}, {"然", "ran"}, {"子", "zi"}, {"轩", "xuan"}, {"梓", "zi"}, {"涵", "han"},
+    {"欣", "xin"}, {"怡", "yi"}, {"佳", "jia"}, {"琪", "qi"}, {"雨", "yu"}, {"萱", "xuan"}, {"思", "si"},
+    {"晨", "chen"}, {"博", "bo"}, {"俊", "jun"}, {"嘉", "jia"}, {"鹏", "peng"}, {"飞", "fei"},
+    {"婷", "ting"}, {"雪", "xue"}, {"慧", "hui"}, {"晓", "xiao"}, {"东", "dong"}, {"海", "hai"},
+    {"志", "zhi"}, {"斌", "bin"}, {"凯", "kai"}, {"昊", "hao"}, {"天", "tian"}, {"一", "yi"},
+    {"诗", "shi"}, {"雅", "ya"}, {"悦", "yue"}, {"航", "hang"}, {"泽", "ze"}, {"睿", "rui"},
+    {"铭", "ming"}, {"春", "chun"}, {"新", "xin"}, {"波", "bo"}, {"峰", "feng"}, {"亮", "liang"},
+    {"健", "jian"}, {"三", "san"}, {"四", "si"}, {"五", "wu"}, {"六", "liu"}, {"七", "qi"}, {"八", "ba"},
+    {"九", "jiu"}, {"十", "shi"}, {"小", "xiao"}, {"大", "da"}, {"立", "li"}, {"振", "zhen"},
+    {"永", "yong"}, {"家", "jia"}, {"豪", "hao"}, {"逸", "yi"}, {"晗", "han"}, {"瑶", "yao"},
+    {"琳", "lin"}, {"颖", "ying"}, {"倩", "qian"}, {"璐", "lu"}, {"蕾", "lei"}, {"月", "yue"},
+    {"云", "yun"}, {"霞", "xia"}, {"凤", "feng"}, {"燕", "yan"}, {"宏", "hong"}, {"德", "de"},
+    {"良", "liang"}, {"义", "yi"}, {"生", "sheng"}, {"山", "shan"}, {"仁", "ren"}, {"元", "yuan"},
+    {"中", "zhong"}, {"民", "min"}, {"光", "guang"}, {"福", "fu"}, {"贵", "gui"}, {"祥", "xiang"},
+    {"瑞", "rui"}, {"庆", "qing"}, {"桐", "tong"}, {"楠", "nan"}, {"钰", "yu"}, {"淑", "shu"},
+    {"珍", "zhen"}, {"芬", "fen"}, {"莉", "li"}, {"萍", "ping"}, {"琴", "qin"}, {"兵", "bing"},
+    {"彬", "bin"}, {"毅", "yi"}, {"忠", "zhong"}, {"诚", "cheng"}, {"信", "xin"}, {"亚", "ya"},
+    {"蓉", "rong"}, {"薇", "wei"}, {"菲", "fei"}, {"璇", "xuan"}, {"瑾", "jin"}, {"婧", "jing"},
+    {"妍", "yan"}, {"琦", "qi"}, {"晶", "jing"}, {"露", "lu"}, {"莹", "ying"}, {"翔", "xiang"},
+    {"宸", "chen"}, {"煜", "yu"}, {"皓", "hao"}, {"瀚", "han"}, {"锦", "jin"}, {"奕", "yi"},
+    {"彤", "tong"}, {"馨", "xin"}, {"曦", "xi"}, {"茜", "qian"}, {"佩", "pei"}, {"婉", "wan"},
+    {"淼", "miao"}, {"哲", "zhe"}, {"腾", "teng"}, {"达", "da"}, {"鸿", "hong"}, {"伦", "lun"},
+    {"帅", "shuai"}, {"坤", "kun"}, {"琛", "chen"}, {"骏", "jun"}, {"晖", "hui"}, {"耀", "yao"},
+    {"锋", "feng"}, {"剑", "jian"}, {"松", "song"}, {"森", "sen"}, {"岩", "yan"}, {"冰", "bing"},
+    {"清", "qing"}, {"源", "yuan"}, {"旭", "xu"}, {"晟", "sheng"}, {"朗", "lang"}, {"阔", "kuo"},
+    {"乐", "le"}, {"欢", "huan"}, {"笑", "xiao"}, {"美", "mei"}, {"爱", "ai"}, {"珊", "shan"},
+    {"珠", "zhu"}, {"蓓", "bei"}, {"蕊", "rui"}, {"芸", "yun"}, {"岚", "lan"}, {"秋", "qiu"},
+    {"冬", "dong"}, {"梦", "meng"}, {"若", "ruo"}, {"依", "yi"}, {"可", "ke"}, {"心", "xin"},
+    {"如", "ru"}, {"意", "yi"}, {"之", "zhi"}, {"以", "yi"}, {"语", "yu"}, {"言", "yan"}, {"书", "shu"},
+    {"墨", "mo"}, {"恒", "heng"}, {"毓", "yu"}, {"嵩", "song"}, {"敬", "jing"}, {"修", "xiu"},
+    {"远", "yuan"}, {"致", "zhi"}
+};
+
+/**
+ * @brief 查询串归一化：转小写并去掉空格、撇号等分隔符
+ * @param query 查询串
+ * @return std::string 归一化后的查询串
+ */
+std::string normalize_query(const std::string& query) {
+    std::string result;
+    for (unsigned char ch : query) {
+        if (ch == ' ' || ch == '\'' || ch == '-' || ch == '\t') continue;
+        result.push_back(static_cast<char>(std::tolower(ch)));
+    }
+    return result;
+}
+
+/**
+ * @brief 将码点按UTF-8编码追加到字符串
+ * @param out 目标字符串
+ * @param codepoint Unicode码点
+ */
+void append_utf8(std::string& out, char32_t codepoint) {
+    if (codepoint < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (codepoint >> 6)));
+    } else if (codepoint < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (codepoint >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (codepoint >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+    }
+    out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+}
+
+} // namespace
+
+NameSearchIndex::NameSearchIndex() {
+    for (const auto& [hanzi, pinyin] : kBuiltinPinyin) {
+        std::u32string codepoints = utf8_to_codepoints(hanzi);
+        if (codepoints.size() == 1) {
+            pinyin_table_[codepoints[0]] = pinyin;
+        }
+    }
+}
+
+std::string NameSearchIndex::to_pinyin(const std::string& name) const {
+    std::string result;
+    for (char32_t codepoint : utf8_to_codepoints(name)) {
+        auto it = pinyin_table_.find(codepoint);
+        if (it != pinyin_table_.end()) {
+            result += it->second;
+        } else if (codepoint < 0x80) {
+            if (!std::isspace(static_cast<int>(codepoint))) {
+                result.push_back(static_cast<char>(std::tolower(static_cast<int>(codepoint))));
+            }
+        } else {
+            append_utf8(result, codepoint);  // 拼音表中没有的字原样保留
+        }
+    }
+    return result;
+}
+
+std::string NameSearchIndex::to_initials(const std::string& name) const {
+    std::string result;
+    for (char32_t codepoint : utf8_to_codepoints(name)) {
+        auto it = pinyin_table_.find(codepoint);
+        if (it != pinyin_table_.end()) {
+            result.push_back(it->second[0]);
+        } else if (codepoint < 0x80 && std::isalpha(static_cast<int>(codepoint))) {
+            result.push_back(static_cast<char>(std::tolower(static_cast<int>(codepoint))));
+        }
+    }
+    return result;
+}
+
+void NameSearchIndex::index_pinyin(const std::string& name) {
+    std::string pinyin = to_pinyin(name);
+    pinyin_tree_.insert(pinyin);
+    by_pinyin_[pinyin].insert(name);
+    by_initials_[to_initials(name)].insert(name);
+}
+
+void NameSearchIndex::unindex_pinyin(const std::string& name) {
+    std::string pinyin = to_pinyin(name);
+    pinyin_tree_.erase(pinyin);
+    
+    auto it = by_pinyin_.find(pinyin);
+    if (it != by_pinyin_.end()) {
+        it->second.erase(name);
+        if (it->second.empty()) by_pinyin_.erase(it);
+    }
+    auto initials = by_initials_.find(to_initials(name));
+    if (initials != by_initials_.end()) {
+        initials->second.erase(name);
+        if (initials->second.empty()) by_initials_.erase(initials);
+    }
+}
+
+void NameSearchIndex::insert(const std::string& name) {
+    // 两棵BK树和拼音映射只保存不同的姓名
+    if (names_[name]++ > 0) return;
+    name_tree_.insert(name);
+    index_pinyin(name);
+}
+
+void NameSearchIndex::erase(const std::string& name) {
+    auto it = names_.find(name);
+    if (it == names_.end()) return;
+    if (--it->second > 0) return;
+    
+    names_.erase(it);
+    name_tree_.erase(name);
+    unindex_pinyin(name);
+}
+
+void NameSearchIndex::clear() {
+    names_.clear();
+    by_pinyin_.clear();
+    by_initials_.clear();
+    name_tree_.clear();
+    pinyin_tree_.clear();
+}
+
+size_t NameSearchIndex::load_pinyin_table(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) return 0;
+    
+    size_t loaded = 0;
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t comma = line.find(',');
+        if (comma == std::string::npos) continue;
+        
+        std::u32string hanzi = utf8_to_codepoints(line.substr(0, comma));
+        std::string pinyin = normalize_query(line.substr(comma + 1));
+        pinyin.erase(std::remove(pinyin.begin(), pinyin.end(), '\r'), pinyin.end());
+        if (hanzi.size() != 1 || pinyin.empty() ||
+            !std::all_of(pinyin.begin(), pinyin.end(), [](unsigned char ch) { return std::isalpha(ch); })) {
+            continue;
+        }
+        pinyin_table_[hanzi[0]] = pinyin;
+        ++loaded;
+    }
+    
+    // 拼音表变化后全拼和首字母均可能改变，重建拼音索引
+    if (loaded > 0) {
+        by_pinyin_.clear();
+        by_initials_.clear();
+        pinyin_tree_.clear();
+        for (const auto& [name, count] : names_) {
+            index_pinyin(name);
+        }
+    }
+    return loaded;
+}
+
+std::vector<NameSearchResult> NameSearchIndex::search(const std::string& query, int max_distance,
+                                                      size_t max_visits) const {
+    std::map<std::string, int> best;  // 姓名->最小距离
+    auto consider = [&best](const std::string& name, int distance) {
+        auto [it, inserted] = best.emplace(name, distance);
+        if (!inserted && distance < it->second) it->second = distance;
+    };
+    
+    std::string normalized = normalize_query(query);
+    if (normalized.empty()) return {};
+    bool ascii = std::all_of(normalized.begin(), normalized.end(),
+                             [](unsigned char ch) { return ch < 0x80; });
+    
+    if (ascii) {
+        // 拼音模式：全拼容错匹配，短于3个字母的部分不容错
+        int limit = std::min(max_distance, static_cast<int>(normalized.size() / 3));
+        for (const auto& [pinyin, distance] : pinyin_tree_.search(normalized, limit, max_visits)) {
+            auto it = by_pinyin_.find(pinyin);
+            if (it == by_pinyin_.end()) continue;
+            for (const auto& name : it->second) consider(name, distance);
+        }
+        // 首字母精确匹配
+        auto initials = by_initials_.find(normalized);
+        if (initials != by_initials_.end()) {
+            for (const auto& name : initials->second) consider(name, 0);
+        }
+    } else {
+        // 汉字模式：按字容错匹配，每两个字最多容许一处差异
+        int length = static_cast<int>(utf8_to_codepoints(normalized).size());
+        int limit = std::min(max_distance, length / 2);
+        for (const auto& [name, distance] : name_tree_.search(query, limit, max_visits)) {
+            consider(name, distance);
+        }
+        // 同音字（全拼相同）视为相差一处
+        auto homophones = by_pinyin_.find(to_pinyin(query));
+        if (homophones != by_pinyin_.end()) {
+            for (const auto& name : homophones->second) consider(name, name == query ? 0 : 1);
+        }
+    }
+    
+    std::vector<NameSearchResult> result;
+    result.reserve(best.size());
+    for (const auto& [name, distance] : best) {
+        result.push_back({name, distance});
+    }
+    std::stable_sort(result.begin(), result.end(),
+        [](const NameSearchResult& a, const NameSearchResult& b) { return a.distance < b.distance; });
+    return result;
+}
+
+uint64_t NameSearchIndex::table_fingerprint() const {
+    // 各条目哈希相加，与unordered_map的遍历顺序无关
+    uint64_t fingerprint = pinyin_table_.size();
+    for (const auto& [hanzi, pinyin] : pinyin_table_) {
+        uint64_t h = 1469598103934665603ULL ^ static_cast<uint64_t>(hanzi);
+        for (unsigned char ch : pinyin) {
+            h = (h ^ ch) * 1099511628211ULL;
+        }
+        fingerprint += h * 0x9e3779b97f4a7c15ULL;
+    }
+    return fingerprint;
+}
+
+void NameSearchIndex::serialize(std::string& out) const {
+    write_pod(out, table_fingerprint());
+    write_pod(out, static_cast<uint64_t>(names_.size()));
+    for (const auto& [name, count] : names_) {
+        write_string(out, name);
+        write_pod(out, static_cast<uint64_t>(count));
+    }
+    
+    std::string tree;
+    name_tree_.serialize(tree);
+    write_string(out, tree);
+    tree.clear();
+    pinyin_tree_.serialize(tree);
+    write_string(out, tree);
+}
+
+bool NameSearchIndex::deserialize(const char* data, size_t size) {
+    BinaryReader reader(data, size);
+    uint64_t fingerprint = 0;
+    uint64_t name_count = 0;
+    if (!reader.read(fingerprint) || fingerprint != table_fingerprint() ||
+        !reader.read(name_count) || name_count > size) {
+        return false;
+    }
+    
+    std::unordered_map<std::string, size_t> names;
+    names.reserve(static_cast<size_t>(name_count));
+    for (uint64_t i = 0; i < name_count; ++i) {
+        std::string name;
+        uint64_t count = 0;
+        if (!reader.read_string(name) || !reader.read(count)) return false;
+        names[std::move(name)] = static_cast<size_t>(count);
+    }
+    
+    std::string tree;
+    BKTree name_tree;
+    BKTree pinyin_tree;
+    if (!reader.read_string(tree) || !name_tree.deserialize(tree.data(), tree.size())) return false;
+    if (!reader.read_string(tree) || !pinyin_tree.deserialize(tree.data(), tree.size())) return false;
+    if (!reader.at_end()) return false;
+    
+    // 拼音映射只是按姓名计算的查找表，重建不涉及编辑距离
+    std::unordered_map<std::string, std::set<std::string>> by_pinyin;
+    std::unordered_map<std::string, std::set<std::string>> by_initials;
+    for (const auto& entry : names) {
+        by_pinyin[to_pinyin(entry.first)].insert(entry.first);
+        by_initials[to_initials(entry.first)].insert(entry.first);
+    }
+    
+    names_ = std::move(names);
+    by_pinyin_ = std::move(by_pinyin);
+    by_initials_ = std::move(by_initials);
+    name_tree_ = std::move(name_tree);
+    pinyin_tree_ = std::move(pinyin_tree);
+    return true;
+}
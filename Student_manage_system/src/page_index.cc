@@ -0,0 +1,170 @@
+#include "page_index.hh"
+#include <algorithm>
+#include <numeric>
+
+PageIndex::PageIndex(StudentSortKey key) : sort_key_(key) {}
+
+PageKey PageIndex::key_of(const Student& student) const {
+    PageKey key;
+    key.id = student.get_id_key();
+    if (sort_key_ == StudentSortKey::NAME) {
+        key.text = student.get_name();
+    } else if (sort_key_ == StudentSortKey::CLASS_ID) {
+        key.text = student.get_class_id();
+    } else if (sort_key_ == StudentSortKey::AVERAGE_SCORE) {
+        key.average = student.get_average_score();
+    }
+    return key;
+}
+
+bool PageIndex::before(const PageKey& a, const PageKey& b) const {
+    if (sort_key_ == StudentSortKey::AVERAGE_SCORE) {
+        if (a.average != b.average) return a.average > b.average;
+    } else if (sort_key_ != StudentSortKey::ID && a.text != b.text) {
+        return a.text < b.text;
+    }
+    return a.id < b.id;
+}
+
+uint32_t PageIndex::allocate(PageKey key) {
+    uint64_t hash = StudentIdHash()(key.id);
+    uint32_t node = free_;
+    if (node == NIL) {
+        node = static_cast<uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+    } else {
+        free_ = nodes_[node].left;
+    }
+    
+    Node& created = nodes_[node];
+    created.key = std::move(key);
+    created.priority = static_cast<uint32_t>(hash ^ (hash >> 32));
+    created.left = NIL;
+    created.right = NIL;
+    created.size = 1;
+    return node;
+}
+
+void PageIndex::update(uint32_t node) {
+    nodes_[node].size = size_of(nodes_[node].left) + size_of(nodes_[node].right) + 1;
+}
+
+void PageIndex::split(uint32_t node, const PageKey& key, bool inclusive, uint32_t& left, uint32_t& right) {
+    if (node == NIL) {
+        left = NIL;
+        right = NIL;
+        return;
+    }
+    
+    bool to_left = inclusive ? !before(key, nodes_[node].key) : before(nodes_[node].key, key);
+    if (to_left) {
+        split(nodes_[node].right, key, inclusive, nodes_[node].right, right);
+        left = node;
+    } else {
+        split(nodes_[node].left, key, inclusive, left, nodes_[node].left);
+        right = node;
+    }
+    update(node);
+}
+
+uint32_t PageIndex::merge(uint32_t left, uint32_t right) {
+    if (left == NIL) return right;
+    if (right == NIL) return left;
+    
+    if (nodes_[left].priority >= nodes_[right].priority) {
+        uint32_t child = merge(nodes_[left].right, right);
+        nodes_[left].right = child;
+        update(left);
+        return left;
+    }
+    uint32_t child = merge(left, nodes_[right].left);
+    nodes_[right].left = child;
+    update(right);
+    return right;
+}
+
+void PageIndex::insert(const Student& student) {
+    uint32_t node = allocate(key_of(student));
+    uint32_t left = NIL;
+    uint32_t right = NIL;
+    split(root_, nodes_[node].key, false, left, right);
+    root_ = merge(merge(left, node), right);
+}
+
+void PageIndex::erase(const Student& student) {
+    PageKey key = key_of(student);
+    uint32_t left = NIL;
+    uint32_t middle = NIL;
+    uint32_t right = NIL;
+    split(root_, key, false, left, right);
+    split(right, key, true, middle, right);
+    
+    // 中间部分只有该学生一个节点，放回空闲链表
+    if (middle != NIL) {
+        nodes_[middle].key = PageKey();
+        nodes_[middle].left = free_;
+        free_ = middle;
+    }
+    root_ = merge(left, right);
+}
+
+void PageIndex::build(const std::list<Student>& students) {
+    nodes_.clear();
+    root_ = NIL;
+    free_ = NIL;
+    nodes_.reserve(students.size());
+    for (const auto& student : students) allocate(key_of(student));
+    
+    std::vector<uint32_t> order(nodes_.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+        return before(nodes_[a].key, nodes_[b].key);
+    });
+    
+    // 按顺序逐个挂到最右链上：优先级更低的链尾节点成为它的左子树，出链的节点子树已完整
+    std::vector<uint32_t> spine;
+    for (uint32_t node : order) {
+        uint32_t last = NIL;
+        while (!spine.empty() && nodes_[spine.back()].priority < nodes_[node].priority) {
+            last = spine.back();
+            spine.pop_back();
+            update(last);
+        }
+        nodes_[node].left = last;
+        if (!spine.empty()) nodes_[spine.back()].right = node;
+        spine.push_back(node);
+    }
+    while (!spine.empty()) {
+        update(spine.back());
+        root_ = spine.back();
+        spine.pop_back();
+    }
+}
+
+size_t PageIndex::page_after(const PageKey* cursor, size_t count, std::vector<StudentId>& ids) const {
+    ids.clear();
+    
+    // 从根向下找第一个排在游标之后的节点，向左走过的节点就是中序遍历中依次要访问的祖先；
+    // 向右走时跳过的左子树和节点本身都不晚于游标
+    std::vector<uint32_t> pending;
+    size_t skipped = 0;
+    for (uint32_t node = root_; node != NIL;) {
+        if (!cursor || before(*cursor, nodes_[node].key)) {
+            pending.push_back(node);
+            node = nodes_[node].left;
+        } else {
+            skipped += size_of(nodes_[node].left) + 1;
+            node = nodes_[node].right;
+        }
+    }
+    
+    while (ids.size() < count && !pending.empty()) {
+        uint32_t node = pending.back();
+        pending.pop_back();
+        ids.push_back(nodes_[node].key.id);
+        for (uint32_t child = nodes_[node].right; child != NIL; child = nodes_[child].left) {
+            pending.push_back(child);
+        }
+    }
+    return size() - skipped - ids.size();
+}
@@ -0,0 +1,191 @@
+#include "prefix_index.hh"
+#include "binary_io.hh"
+
+PrefixIndex::PrefixIndex() {
+    clear();
+}
+
+void PrefixIndex::clear() {
+    nodes_.clear();
+    nodes_.emplace_back();
+    dead_nodes_ = 0;
+}
+
+uint32_t PrefixIndex::find_child(uint32_t node, unsigned char byte) const {
+    for (uint32_t child = nodes_[node].first_child; child != NIL; child = nodes_[child].next_sibling) {
+        if (nodes_[child].byte == byte) return child;
+        if (nodes_[child].byte > byte) break;
+    }
+    return NIL;
+}
+
+void PrefixIndex::insert(const std::string& key) {
+    uint32_t node = 0;
+    nodes_[0].count++;
+    
+    for (unsigned char byte : key) {
+        // 在有序兄弟链表中查找或插入
+        uint32_t prev = NIL;
+        uint32_t child = nodes_[node].first_child;
+        while (child != NIL && nodes_[child].byte < byte) {
+            prev = child;
+            child = nodes_[child].next_sibling;
+        }
+        
+        if (child == NIL || nodes_[child].byte != byte) {
+            Node created;
+            created.byte = byte;
+            created.next_sibling = child;
+            uint32_t index = static_cast<uint32_t>(nodes_.size());
+            nodes_.push_back(created);
+            if (prev == NIL) {
+                nodes_[node].first_child = index;
+            } else {
+                nodes_[prev].next_sibling = index;
+            }
+            child = index;
+        }
+        
+        node = child;
+        nodes_[node].count++;
+    }
+    nodes_[node].terminal++;
+}
+
+bool PrefixIndex::erase(const std::string& key) {
+    // 先确认键存在，再沿路径减少计数
+    std::vector<uint32_t> path;
+    path.reserve(key.size() + 1);
+    path.push_back(0);
+    
+    uint32_t node = 0;
+    for (unsigned char byte : key) {
+        node = find_child(node, byte);
+        if (node == NIL) return false;
+        path.push_back(node);
+    }
+    if (nodes_[node].terminal == 0) return false;
+    
+    nodes_[node].terminal--;
+    for (uint32_t index : path) {
+        nodes_[index].count--;
+    }
+    
+    // 计数不会大于祖先的计数，路径上第一个变为0的节点以下都只属于这个键，整段摘下
+    size_t depth = 1;
+    while (depth < path.size() && nodes_[path[depth]].count > 0) ++depth;
+    if (depth < path.size()) {
+        uint32_t parent = path[depth - 1];
+        uint32_t child = path[depth];
+        if (nodes_[parent].first_child == child) {
+            nodes_[parent].first_child = nodes_[child].next_sibling;
+        } else {
+            uint32_t prev = nodes_[parent].first_child;
+            while (nodes_[prev].next_sibling != child) prev = nodes_[prev].next_sibling;
+            nodes_[prev].next_sibling = nodes_[child].next_sibling;
+        }
+        dead_nodes_ += path.size() - depth;
+        
+        if (dead_nodes_ * 2 > nodes_.size()) {
+            nodes_ = live_nodes();
+            dead_nodes_ = 0;
+        }
+    }
+    return true;
+}
+
+std::vector<PrefixIndex::Node> PrefixIndex::live_nodes() const {
+    std::vector<Node> nodes;
+    nodes.reserve(nodes_.size() - dead_nodes_);
+    nodes.push_back(nodes_[0]);
+    
+    // 新数组本身就是队列：复制进来的节点的first_child仍是旧下标，轮到它时再改写
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        uint32_t child = nodes[i].first_child;
+        uint32_t prev = NIL;
+        nodes[i].first_child = NIL;
+        for (; child != NIL; child = nodes_[child].next_sibling) {
+            if (nodes_[child].count == 0) continue;
+            uint32_t index = static_cast<uint32_t>(nodes.size());
+            nodes.push_back(nodes_[child]);
+            nodes.back().next_sibling = NIL;
+            if (prev == NIL) {
+                nodes[i].first_child = index;
+            } else {
+                nodes[prev].next_sibling = index;
+            }
+            prev = index;
+        }
+    }
+    return nodes;
+}
+
+void PrefixIndex::collect(uint32_t node, std::string& prefix, size_t limit,
+                          std::vector<std::string>& out) const {
+    if (out.size() >= limit || nodes_[node].count == 0) return;
+    
+    if (nodes_[node].terminal > 0) {
+        out.push_back(prefix);
+    }
+    for (uint32_t child = nodes_[node].first_child; child != NIL && out.size() < limit;
+         child = nodes_[child].next_sibling) {
+        if (nodes_[child].count == 0) continue;
+        prefix.push_back(static_cast<char>(nodes_[child].byte));
+        collect(child, prefix, limit, out);
+        prefix.pop_back();
+    }
+}
+
+std::vector<std::string> PrefixIndex::complete(const std::string& prefix, size_t limit) const {
+    std::vector<std::string> result;
+    
+    uint32_t node = 0;
+    for (unsigned char byte : prefix) {
+        node = find_child(node, byte);
+        if (node == NIL) return result;
+    }
+    std::string path = prefix;
+    collect(node, path, limit, result);
+    return result;
+}
+
+std::vector<std::string> PrefixIndex::suggest(const std::string& input, size_t limit) const {
+    std::vector<std::string> result;
+    
+    // 沿输入走到仍有键的最深节点，从该处补全
+    uint32_t node = 0;
+    size_t matched = 0;
+    for (unsigned char byte : input) {
+        uint32_t child = find_child(node, byte);
+        if (child == NIL || nodes_[child].count == 0) break;
+        node = child;
+        ++matched;
+    }
+    std::string path = input.substr(0, matched);
+    collect(node, path, limit, result);
+    return result;
+}
+
+void PrefixIndex::serialize(std::string& out) const {
+    if (dead_nodes_ == 0) {
+        write_array(out, nodes_);
+    } else {
+        write_array(out, live_nodes());
+    }
+}
+
+bool PrefixIndex::deserialize(const char* data, size_t size) {
+    BinaryReader reader(data, size);
+    std::vector<Node> nodes;
+    if (!reader.read_array(nodes) || !reader.at_end() || nodes.empty()) return false;
+    
+    for (const auto& node : nodes) {
+        if ((node.first_child != NIL && node.first_child >= nodes.size()) ||
+            (node.next_sibling != NIL && node.next_sibling >= nodes.size())) {
+            return false;
+        }
+    }
+    nodes_ = std::move(nodes);
+    dead_nodes_ = 0;
+    return true;
+}
@@ -0,0 +1,184 @@
+#include "replica.hh"
+#include <fstream>
+
+namespace {
+
+int64_t now_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+StudentReplica::StudentReplica(std::string log_filename)
+    : log_filename_(std::move(log_filename)), logger_("StudentReplica") {
+    // 副本逐条重放事件，关闭存储层的逐条INFO日志
+    store_.set_log_level(LogLevel::WARN);
+}
+
+StudentReplica::~StudentReplica() {
+    stop();
+}
+
+void StudentReplica::start(std::chrono::milliseconds poll_interval) {
+    if (running_.exchange(true)) return;
+    
+    tail_thread_ = std::thread([this, poll_interval]() {
+        while (running_) {
+            poll();
+            std::unique_lock<std::mutex> lock(wait_mutex_);
+            wait_cv_.wait_for(lock, poll_interval, [this]() { return !running_; });
+        }
+    });
+    logger_.info("开始追读变更日志：" + log_filename_);
+}
+
+void StudentReplica::stop() {
+    if (!running_.exchange(false)) return;
+    wait_cv_.notify_all();
+    if (tail_thread_.joinable()) tail_thread_.join();
+}
+
+size_t StudentReplica::poll() {
+    std::lock_guard<std::mutex> poll_lock(poll_mutex_);
+    
+    std::ifstream file(log_filename_, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return 0;
+    
+    uint64_t size = static_cast<uint64_t>(file.tellg());
+    if (size < offset_ || !same_log(file)) {
+        // 日志被截断或替换，从头重放
+        logger_.warn("变更日志被截断或替换，副本将从头重放：" + log_filename_);
+        offset_ = 0;
+        partial_line_.clear();
+        first_line_.clear();
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        store_.clear_all_students();
+        lag_ = ReplicaLag();
+    }
+    
+    uint64_t offset = offset_;
+    std::string chunk(static_cast<size_t>(size - offset), '\0');
+    file.seekg(static_cast<std::streamoff>(offset));
+    file.read(&chunk[0], static_cast<std::streamsize>(chunk.size()));
+    offset_ = offset + static_cast<uint64_t>(file.gcount());
+    chunk.resize(static_cast<size_t>(file.gcount()));
+    partial_line_ += chunk;
+    
+    // 第一行记录之前partial_line_总是从文件开头开始
+    if (first_line_.empty()) {
+        size_t first_newline = partial_line_.find('\n');
+        if (first_newline != std::string::npos) first_line_ = partial_line_.substr(0, first_newline + 1);
+    }
+    
+    // 读取和解码不持有mutex_；每解码一批事件持一次写锁应用，批次之间查询可以进行
+    size_t applied = 0;
+    size_t line_start = 0;
+    std::vector<ChangeEvent> batch;
+    batch.reserve(APPLY_BATCH);
+    for (bool more = true; more;) {
+        batch.clear();
+        size_t skipped = 0;
+        size_t newline;
+        while (batch.size() < APPLY_BATCH && (newline = partial_line_.find('\n', line_start)) != std::string::npos) {
+            std::string line = partial_line_.substr(line_start, newline - line_start);
+            line_start = newline + 1;
+            if (line.empty()) continue;
+            
+            ChangeEvent event;
+            if (!ChangeStream::deserialize(line, event)) {
+                logger_.warn("跳过无法解析的变更事件：" + line);
+                skipped++;
+                continue;
+            }
+            batch.push_back(std::move(event));
+        }
+        more = batch.size() == APPLY_BATCH;
+        
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        lag_.skipped_events += skipped;
+        for (const auto& event : batch) {
+            // 已应用过的序列号直接跳过，保证重复读取时幂等
+            if (event.sequence <= lag_.applied_sequence) continue;
+            
+            if (apply(event)) {
+                applied++;
+                lag_.applied_events++;
+            } else {
+                lag_.skipped_events++;
+            }
+            lag_.applied_sequence = event.sequence;
+            lag_.last_event_timestamp_ms = event.timestamp_ms;
+            lag_.apply_delay_ms = now_ms() - event.timestamp_ms;
+        }
+        if (!more) lag_.pending_bytes = 0;
+    }
+    partial_line_.erase(0, line_start);
+    return applied;
+}
+
+bool StudentReplica::same_log(std::ifstream& file) const {
+    if (first_line_.empty()) return true;
+    
+    std::string head(first_line_.size(), '\0');
+    file.seekg(0);
+    file.read(&head[0], static_cast<std::streamsize>(head.size()));
+    bool same = file.gcount() == static_cast<std::streamsize>(head.size()) && head == first_line_;
+    file.clear();
+    return same;
+}
+
+bool StudentReplica::apply(const ChangeEvent& event) {
+    switch (event.type) {
+        case ChangeType::ADD:
+            return store_.add_student(event.student);
+        case ChangeType::UPDATE:
+            return store_.update_student(event.student_id, event.student);
+        case ChangeType::DELETE:
+            return store_.delete_student(event.student_id);
+        case ChangeType::SCORE_SET:
+            return store_.set_student_score(event.student_id, event.subject, event.score);
+        case ChangeType::CLEAR:
+            store_.clear_all_students();
+            return true;
+        case ChangeType::SNAPSHOT:
+            // 加载的学生已在日志中逐行写为ADD事件
+            return true;
+    }
+    return false;
+}
+
+bool StudentReplica::find_student_by_id(const std::string& student_id, Student& student) {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return store_.find_student_by_id(student_id, student);
+}
+
+std::vector<Student> StudentReplica::find_students_by_name(const std::string& name) {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return store_.find_students_by_name(name);
+}
+
+std::string StudentReplica::get_student_scores_info(const std::string& student_id) {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return store_.get_student_scores_info(student_id);
+}
+
+size_t StudentReplica::get_student_count() {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return store_.get_student_count();
+}
+
+ReplicaLag StudentReplica::lag() {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    ReplicaLag snapshot = lag_;
+    
+    std::ifstream file(log_filename_, std::ios::binary | std::ios::ate);
+    if (file.is_open()) {
+        uint64_t size = static_cast<uint64_t>(file.tellg());
+        snapshot.pending_bytes = size > offset_ ? size - offset_ : 0;
+    }
+    if (snapshot.last_event_timestamp_ms > 0) {
+        snapshot.staleness_ms = now_ms() - snapshot.last_event_timestamp_ms;
+    }
+    return snapshot;
+}
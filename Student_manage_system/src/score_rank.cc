@@ -0,0 +1,79 @@
+#include "score_rank.hh"
+#include <algorithm>
+#include <cmath>
+
+void FenwickTree::add(size_t index, int32_t delta) {
+    for (size_t i = index + 1; i < tree_.size(); i += i & (~i + 1)) {
+        tree_[i] += delta;
+    }
+}
+
+int64_t FenwickTree::prefix_sum(size_t index) const {
+    int64_t sum = 0;
+    for (size_t i = std::min(index + 1, tree_.size() - 1); i > 0; i -= i & (~i + 1)) {
+        sum += tree_[i];
+    }
+    return sum;
+}
+
+size_t ScoreRankIndex::bucket_of(float score) {
+    long bucket = std::lround(static_cast<double>(score) * 10.0);
+    return static_cast<size_t>(std::clamp<long>(bucket, 0, static_cast<long>(BUCKETS) - 1));
+}
+
+void ScoreRankIndex::apply(SubjectCounters& counters, const Student& student, int32_t delta) {
+    if (student.get_score_count() == 0) return;
+    
+    auto update = [&counters, delta](const std::string& subject, float score) {
+        Counter& counter = counters[subject];
+        counter.tree.add(bucket_of(score), delta);
+        counter.total = delta > 0 ? counter.total + 1 : counter.total - 1;
+        if (counter.total == 0) counters.erase(subject);
+    };
+    for (const auto& [subject, score] : student.get_scores()) {
+        update(subject, score);
+    }
+    update(std::string(), student.get_average_score());
+}
+
+void ScoreRankIndex::insert(const Student& student) {
+    if (student.get_score_count() == 0) return;
+    apply(school_, student, 1);
+    apply(classes_[student.get_class_id()], student, 1);
+}
+
+void ScoreRankIndex::erase(const Student& student) {
+    if (student.get_score_count() == 0) return;
+    apply(school_, student, -1);
+    
+    auto it = classes_.find(student.get_class_id());
+    if (it != classes_.end()) {
+        apply(it->second, student, -1);
+        if (it->second.empty()) classes_.erase(it);
+    }
+}
+
+void ScoreRankIndex::clear() {
+    school_.clear();
+    classes_.clear();
+}
+
+ScoreRank ScoreRankIndex::rank_in(const SubjectCounters& counters, const std::string& subject, float score) {
+    ScoreRank result;
+    auto it = counters.find(subject);
+    if (it == counters.end()) return result;
+    
+    const Counter& counter = it->second;
+    result.total = counter.total;
+    result.rank = counter.total - static_cast<size_t>(counter.tree.prefix_sum(bucket_of(score))) + 1;
+    return result;
+}
+
+ScoreRank ScoreRankIndex::school_rank(const std::string& subject, float score) const {
+    return rank_in(school_, subject, score);
+}
+
+ScoreRank ScoreRankIndex::class_rank(const std::string& class_id, const std::string& subject, float score) const {
+    auto it = classes_.find(class_id);
+    return it == classes_.end() ? ScoreRank() : rank_in(it->second, subject, score);
+}
@@ -0,0 +1,85 @@
+#include "segment_manifest.hh"
+#include "async_file.hh"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <sstream>
+
+std::string SegmentManifest::segment_of(const StudentId& id) {
+    std::string name = id.to_string();
+    size_t digits = std::min(SEGMENT_DIGITS, name.size());
+    name.replace(name.size() - digits, digits, digits, 'x');
+    return name;
+}
+
+std::string SegmentManifest::directory_for(const std::string& manifest) {
+    return manifest + ".seg";
+}
+
+std::string SegmentManifest::file_for(const std::string& manifest, const std::string& segment, uint64_t generation) {
+    std::string base = std::filesystem::path(manifest).filename().string();
+    return base + ".seg/" + segment + "." + std::to_string(generation) + ".csv";
+}
+
+std::string SegmentManifest::resolve(const std::string& manifest, const std::string& file) {
+    return (std::filesystem::path(manifest).parent_path() / file).string();
+}
+
+bool SegmentManifest::load(const std::string& filename) {
+    generation = 0;
+    segments.clear();
+    
+    FileReader file;
+    std::string line;
+    if (!file.open(filename) || !file.read_line(line) || line != MAGIC) return false;
+    if (!file.read_line(line) || line.compare(0, 11, "generation,") != 0) return false;
+    try {
+        generation = std::stoull(line.substr(11));
+    } catch (const std::exception&) {
+        return false;
+    }
+    
+    while (file.read_line(line)) {
+        if (line.empty()) continue;
+        std::istringstream iss(line);
+        std::string name, count, size, crc;
+        SegmentEntry entry;
+        if (!(std::getline(iss, name, ',') && std::getline(iss, entry.file, ',') &&
+              std::getline(iss, count, ',') && std::getline(iss, size, ','))) {
+            return false;
+        }
+        try {
+            entry.count = std::stoul(count);
+            entry.size = std::stoull(size);
+            if (std::getline(iss, crc)) {
+                entry.crc = static_cast<uint32_t>(std::stoul(crc, nullptr, 16));
+                entry.has_crc = true;
+            }
+        } catch (const std::exception&) {
+            return false;
+        }
+        segments[name] = std::move(entry);
+    }
+    return !file.failed();
+}
+
+bool SegmentManifest::save(const std::string& filename) const {
+    std::string text = std::string(MAGIC) + "\ngeneration," + std::to_string(generation) + "\n";
+    for (const auto& [name, entry] : segments) {
+        char crc[16];
+        std::snprintf(crc, sizeof(crc), "%08x", static_cast<unsigned>(entry.crc));
+        text += name + "," + entry.file + "," + std::to_string(entry.count) + "," + std::to_string(entry.size) +
+                "," + crc + "\n";
+    }
+    
+    std::string temp = filename + ".tmp";
+    FileWriter file;
+    if (!file.open(temp)) return false;
+    file.write(text);
+    if (!file.close()) {
+        std::remove(temp.c_str());
+        return false;
+    }
+    std::remove(filename.c_str());
+    return std::rename(temp.c_str(), filename.c_str()) == 0;
+}
@@ -1,35 +1,123 @@
 #include "student.hh"
+#include "student_schema.hh"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+
+namespace {
+
+/**
+ * @brief 按与std::ostream默认格式相同的方式（%g）追加数值
+ * @param buffer 输出缓冲区
+ * @param value 数值
+ */
+void append_number(std::string& buffer, float value) {
+    char text[32];
+    int length = std::snprintf(text, sizeof(text), "%g", value);
+    buffer.append(text, static_cast<size_t>(length));
+}
+
+/**
+ * @brief 追加文本并用空格补齐到指定显示宽度（非ASCII字符按两列计算）
+ * @param buffer 输出缓冲区
+ * @param text 文本
+ * @param width 显示宽度（至少再补一个空格作为列间隔）
+ */
+void append_padded(std::string& buffer, const std::string& text, size_t width) {
+    size_t display = 0;
+    for (unsigned char ch : text) {
+        if (ch < 0x80) {
+            ++display;
+        } else if ((ch & 0xC0) != 0x80) {
+            display += 2;  // UTF-8首字节，中文字符占两列
+        }
+    }
+    buffer += text;
+    buffer.append(display < width ? width - display : 1, ' ');
+}
+
+} // namespace
 
 Student::Student(std::string id, std::string name, std::string gender, 
                 std::string class_id, std::string phone, std::string email)
-    : id_(std::move(id)), name_(std::move(name)), gender_(std::move(gender)),
-      class_id_(std::move(class_id)), phone_(std::move(phone)), email_(std::move(email))
+    : name_(std::move(name)), gender_(std::move(gender)), class_id_(std::move(class_id))
 {
-    validate_id(id_);
+    id_ = validate_id(id);
     validate_name(name_);
     validate_gender(gender_);
     validate_class_id(class_id_);
-    if (!phone_.empty()) validate_phone(phone_);
-    if (!email_.empty()) validate_email(email_);
+    if (!phone.empty()) {
+        phone_ = validate_phone(phone);
+    }
+    if (!email.empty()) {
+        validate_email(email);
+        email_ = std::move(email);
+    }
+}
+
+std::string Student::get_phone() const {
+    return phone_ != 0 ? std::to_string(phone_) : std::string();
+}
+
+void Student::show_info(std::ostream& out) const {
+    std::string buffer;
+    format_into(buffer);
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
 }
 
-void Student::show_info() const {
-    std::cout << "学号: " << id_ << "\n";
-    std::cout << "姓名: " << name_ << "\n";
-    std::cout << "性别: " << gender_ << "\n";
-    std::cout << "班级: " << class_id_ << "\n";
-    std::cout << "电话: " << (phone_.empty() ? "未设置" : phone_) << "\n";
-    std::cout << "邮箱: " << (email_.empty() ? "未设置" : email_) << "\n";
+void Student::format_into(std::string& buffer) const {
+    student_schema::StudentFields::for_each([&](auto descriptor) {
+        using Field = decltype(descriptor);
+        const std::string& value = Field::get(*this);
+        buffer += Field::LABEL;
+        buffer += ": ";
+        if (Field::NULLABLE && value.empty()) {
+            buffer += "未设置";
+        } else {
+            buffer += value;
+        }
+        buffer += "\n";
+    });
     
-    if (!scores_.empty()) {
-        std::cout << "成绩:\n";
+    if (score_count_ > 0) {
+        buffer += "成绩:\n";
         for (const auto& [subject, score] : scores_) {
-            std::cout << "  " << subject << ": " << score << "\n";
+            buffer += "  " + subject + ": ";
+            append_number(buffer, score);
+            buffer += "\n";
         }
-        std::cout << "平均分: " << get_average_score() << "\n";
+        buffer += "平均分: ";
+        append_number(buffer, get_average_score());
+        buffer += "\n";
+    } else {
+        buffer += "成绩: 暂无成绩记录\n";
+    }
+}
+
+void Student::format_row_into(std::string& buffer) const {
+    append_padded(buffer, get_id(), 22);
+    append_padded(buffer, name_, 14);
+    append_padded(buffer, gender_, 6);
+    append_padded(buffer, class_id_, 12);
+    std::string phone = get_phone();
+    append_padded(buffer, phone.empty() ? "-" : phone, 13);
+    append_padded(buffer, std::to_string(score_count_), 8);
+    if (score_count_ == 0) {
+        buffer += "-";
     } else {
-        std::cout << "成绩: 暂无成绩记录\n";
+        append_number(buffer, get_average_score());
     }
+    buffer += "\n";
+}
+
+void Student::format_table_header(std::string& buffer) {
+    append_padded(buffer, "学号", 22);
+    append_padded(buffer, "姓名", 14);
+    append_padded(buffer, "性别", 6);
+    append_padded(buffer, "班级", 12);
+    append_padded(buffer, "电话", 13);
+    append_padded(buffer, "科目数", 8);
+    buffer += "平均分\n";
 }
 
 void Student::set_score(const std::string& subject, float score) {
@@ -39,7 +127,15 @@ void Student::set_score(const std::string& subject, float score) {
     if (score < 0 || score > 100) {
         throw std::invalid_argument("成绩必须在0-100之间");
     }
-    scores_[subject] = score;
+    
+    auto [it, inserted] = scores_.emplace(subject, score);
+    if (inserted) {
+        score_count_++;
+        score_sum_ += score;
+    } else {
+        score_sum_ += static_cast<double>(score) - it->second;
+        it->second = score;
+    }
 }
 
 float Student::get_score(const std::string& subject) const {
@@ -47,22 +143,34 @@ float Student::get_score(const std::string& subject) const {
     return it != scores_.end() ? it->second : -1.0f;
 }
 
+bool Student::remove_score(const std::string& subject) {
+    auto it = scores_.find(subject);
+    if (it == scores_.end()) return false;
+    
+    score_count_--;
+    // 最后一科删除后清零，避免浮点累计误差残留
+    score_sum_ = score_count_ == 0 ? 0.0 : score_sum_ - it->second;
+    scores_.erase(it);
+    return true;
+}
+
 float Student::get_average_score() const {
-    if (scores_.empty()) return 0.0f;
-    float sum = 0.0f;
-    for (const auto& [_, score] : scores_) {
-        sum += score;
-    }
-    return sum / scores_.size();
+    if (score_count_ == 0) return 0.0f;
+    return static_cast<float>(score_sum_ / score_count_);
 }
 
 bool Student::is_valid() const {
-    return !id_.empty() && !name_.empty() && !gender_.empty() && !class_id_.empty();
+    return id_.length > 0 && !name_.empty() && !gender_.empty() && !class_id_.empty();
+}
+
+bool Student::operator==(const Student& other) const {
+    return id_ == other.id_ && name_ == other.name_ && gender_ == other.gender_ &&
+           class_id_ == other.class_id_ &&
+           phone_ == other.phone_ && email_ == other.email_ && scores_ == other.scores_;
 }
 
 void Student::set_id(const std::string& id) {
-    validate_id(id);
-    id_ = id;
+    id_ = validate_id(id);
 }
 
 void Student::set_name(const std::string& name) {
@@ -81,8 +189,7 @@ void Student::set_class_id(const std::string& class_id) {
 }
 
 void Student::set_phone(const std::string& phone) {
-    if (!phone.empty()) validate_phone(phone);
-    phone_ = phone;
+    phone_ = phone.empty() ? 0 : validate_phone(phone);
 }
 
 void Student::set_email(const std::string& email) {
@@ -90,14 +197,18 @@ void Student::set_email(const std::string& email) {
     email_ = email;
 }
 
-void Student::validate_id(const std::string& id) const {
+StudentId Student::validate_id(const std::string& id) const {
     if (id.empty()) throw std::invalid_argument("学号不能为空");
-    if (!std::regex_match(id, std::regex("^\\d+$"))) {
+    if (!std::all_of(id.begin(), id.end(), [](unsigned char ch) { return std::isdigit(ch); })) {
         throw std::invalid_argument("学号必须为纯数字");
     }
     if (id.length() < 3 || id.length() > 20) {
         throw std::invalid_argument("学号长度必须在3-20位之间");
     }
+    
+    StudentId key;
+    StudentId::parse(id, key);
+    return key;
 }
 
 void Student::validate_name(const std::string& name) const {
@@ -118,10 +229,14 @@ void Student::validate_class_id(const std::string& class_id) const {
     if (class_id.length() < 3) throw std::invalid_argument("班级号格式不正确");
 }
 
-void Student::validate_phone(const std::string& phone) const {
-    if (!std::regex_match(phone, std::regex("^1[3-9]\\d{9}$"))) {
+uint64_t Student::validate_phone(const std::string& phone) const {
+    // 等价于^1[3-9]\d{9}$
+    bool valid = phone.size() == 11 && phone[0] == '1' && phone[1] >= '3' && phone[1] <= '9' &&
+                 std::all_of(phone.begin(), phone.end(), [](unsigned char ch) { return std::isdigit(ch); });
+    if (!valid) {
         throw std::invalid_argument("手机号格式不正确（必须是11位数字）");
     }
+    return std::stoull(phone);
 }
 
 void Student::validate_email(const std::string& email) const {
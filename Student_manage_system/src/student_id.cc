@@ -0,0 +1,43 @@
+#include "student_id.hh"
+
+namespace {
+
+constexpr size_t LOW_DIGITS = 19;  ///< low字段存放的十进制位数
+
+} // namespace
+
+bool StudentId::parse(const std::string& text, StudentId& out) {
+    if (text.empty() || text.size() > 20) return false;
+    
+    StudentId result;
+    result.length = static_cast<uint8_t>(text.size());
+    size_t split = text.size() > LOW_DIGITS ? text.size() - LOW_DIGITS : 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        char ch = text[i];
+        if (ch < '0' || ch > '9') return false;
+        if (i < split) {
+            result.high = static_cast<uint8_t>(result.high * 10 + (ch - '0'));
+        } else {
+            result.low = result.low * 10 + static_cast<uint64_t>(ch - '0');
+        }
+    }
+    out = result;
+    return true;
+}
+
+std::string StudentId::to_string() const {
+    if (length == 0) return "";
+    
+    // 从低位向高位填充，未填到的位即为前导零
+    std::string text(length, '0');
+    uint64_t value = low;
+    size_t pos = length;
+    for (size_t digits = 0; digits < LOW_DIGITS && pos > 0; ++digits) {
+        text[--pos] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    if (pos > 0) {
+        text[--pos] = static_cast<char>('0' + high);
+    }
+    return text;
+}
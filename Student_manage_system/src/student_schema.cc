@@ -0,0 +1,93 @@
+#include "student_schema.hh"
+#include "binary_io.hh"
+#include <algorithm>
+
+using student_schema::StudentFields;
+
+bool ColumnSet::parse(const std::string& labels, ColumnSet& columns) {
+    columns = ColumnSet();
+    size_t start = 0;
+    while (start <= labels.size()) {
+        size_t comma = std::min(labels.find(',', start), labels.size());
+        std::string label = labels.substr(start, comma - start);
+        start = comma + 1;
+        label.erase(0, label.find_first_not_of(' '));
+        label.erase(label.find_last_not_of(' ') + 1);
+        if (label.empty()) continue;
+        
+        bool known = label == student_schema::SCORES_LABEL;
+        if (known) columns.add_scores();
+        StudentFields::for_each([&](auto descriptor) {
+            using Field = decltype(descriptor);
+            if (label == Field::LABEL) {
+                columns.add(Field::KEY);
+                known = true;
+            }
+        });
+        if (!known) return false;
+    }
+    return true;
+}
+
+std::string ColumnSet::to_string() const {
+    std::string labels;
+    StudentFields::for_each([&](auto descriptor) {
+        using Field = decltype(descriptor);
+        if (!has(Field::KEY)) return;
+        if (!labels.empty()) labels += ',';
+        labels += Field::LABEL;
+    });
+    if (has_scores()) {
+        if (!labels.empty()) labels += ',';
+        labels += student_schema::SCORES_LABEL;
+    }
+    return labels;
+}
+
+std::string get_student_field(const Student& student, StudentField field) {
+    std::string value;
+    StudentFields::visit(field, [&](auto descriptor) {
+        value = decltype(descriptor)::get(student);
+    });
+    return value;
+}
+
+void set_student_field(Student& student, StudentField field, const std::string& value) {
+    StudentFields::visit(field, [&](auto descriptor) {
+        decltype(descriptor)::set(student, value);
+    });
+}
+
+void append_student_binary(std::string& out, const Student& student) {
+    StudentFields::for_each([&](auto descriptor) {
+        write_string(out, decltype(descriptor)::get(student));
+    });
+    const auto& scores = student.get_scores();
+    write_pod(out, static_cast<uint32_t>(scores.size()));
+    for (const auto& [subject, score] : scores) {
+        write_string(out, subject);
+        write_pod(out, score);
+    }
+}
+
+bool student_from_binary(const char* data, size_t size, Student& student) {
+    BinaryReader reader(data, size);
+    Student decoded;
+    std::string value;
+    bool ok = true;
+    StudentFields::for_each([&](auto descriptor) {
+        ok = ok && reader.read_string(value);
+        if (ok) decltype(descriptor)::set(decoded, value);
+    });
+    
+    uint32_t count = 0;
+    if (!ok || !reader.read(count)) return false;
+    for (uint32_t i = 0; i < count; ++i) {
+        float score = 0.0f;
+        if (!reader.read_string(value) || !reader.read(score)) return false;
+        decoded.set_score(value, score);
+    }
+    if (!reader.at_end()) return false;
+    student = std::move(decoded);
+    return true;
+}
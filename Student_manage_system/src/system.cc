@@ -1,354 +1,1731 @@
 #include "system.hh"
+#include "csv_codec.hh"
+#include "student_schema.hh"
+#include "parallel_sort.hh"
+#include "thread_pool.hh"
+#include "block_checksum.hh"
+#include "crc32c.hh"
+#include "concurrent_id_set.hh"
+#include "async_file.hh"
 #include <sstream>
 #include <iostream>
 #include <algorithm>
+#include <unordered_set>
+#include <iomanip>
+#include <filesystem>
+#include <functional>
+
+namespace {
+
+/**
+ * @struct SortColumn
+ * @brief 一个排序键的预取值：比较时只访问连续数组，不再查找成绩表
+ */
+struct SortColumn {
+    SortField field;                         ///< 排序字段
+    bool descending;                         ///< 是否降序
+    std::vector<float> numbers;              ///< 平均分或科目成绩（缺失为-1）
+    std::vector<const std::string*> texts;   ///< 姓名或班级号
+    std::vector<StudentId> ids;              ///< 学号
+};
+
+/**
+ * @brief 比较两名学生在一个排序键下的先后
+ * @param column 排序键的预取值
+ * @param a 第一名学生的下标
+ * @param b 第二名学生的下标
+ * @return int 负数表示a在前，正数表示b在前，0表示相同
+ */
+int compare_column(const SortColumn& column, uint32_t a, uint32_t b) {
+    int result = 0;
+    if (column.field == SortField::ID) {
+        result = column.ids[a] < column.ids[b] ? -1 : (column.ids[b] < column.ids[a] ? 1 : 0);
+    } else if (column.field == SortField::NAME || column.field == SortField::CLASS_ID) {
+        result = column.texts[a]->compare(*column.texts[b]);
+    } else {
+        float x = column.numbers[a];
+        float y = column.numbers[b];
+        // 缺失值无论升序降序都排在最后
+        if ((x < 0) != (y < 0)) return x < 0 ? 1 : -1;
+        result = x < y ? -1 : (x > y ? 1 : 0);
+    }
+    return column.descending ? -result : result;
+}
+
+/**
+ * @struct ParsedFile
+ * @brief 多文件加载时一个文件的解析结果
+ */
+struct ParsedFile {
+    bool opened = false;             ///< 文件是否成功打开
+    size_t corrupt_blocks = 0;       ///< 校验失败的块数（不为0时整个文件不加载）
+    std::vector<Student> students;   ///< 通过验证的学生
+    std::vector<size_t> lines;       ///< 每名学生所在的行号
+    std::vector<LoadIssue> issues;   ///< 被跳过的行
+    size_t invalid = 0;              ///< 格式错误或验证失败的行数
+};
+
+/**
+ * @brief 解析一个名册文件并声明其中的学号（在工作线程中执行，不写日志）
+ * @param filename 文件名
+ * @param file_index 文件在列表中的下标，与行号一起构成声明序号
+ * @param ids 各文件共享的学号集合
+ * @param columns 需要解析的列
+ * @return ParsedFile 解析结果
+ */
+ParsedFile parse_roster_file(const std::string& filename, uint64_t file_index, ConcurrentIdSet& ids,
+                             const ColumnSet& columns) {
+    ParsedFile parsed;
+    FileReader file;
+    if (!file.open(filename)) return parsed;
+    parsed.opened = true;
+    
+    // 已在线程池中，各文件的块校验在本线程内进行
+    BlockChecksums checksums;
+    std::vector<uint64_t> bad_blocks;
+    if (checksums.read(BlockChecksums::path_for(filename)) && checksums.matches(filename) &&
+        !checksums.verify(filename, bad_blocks, 1)) {
+        parsed.corrupt_blocks = bad_blocks.size();
+        return parsed;
+    }
+    
+    auto skip = [&parsed, &filename](size_t line_number, const std::string& message, bool invalid) {
+        parsed.issues.push_back({filename, line_number, message});
+        if (invalid) parsed.invalid++;
+    };
+    
+    std::string line;
+    std::vector<std::string> skipped_scores;
+    for (size_t line_number = 1; file.read_line(line); ++line_number) {
+        // 第一行含"学号"时视为Excel表头
+        if (line.empty() || (line_number == 1 && line.find("学号") != std::string::npos)) continue;
+        
+        Student student;
+        skipped_scores.clear();
+        try {
+            if (!student_from_csv(line, student, &skipped_scores, columns)) {
+                skip(line_number, "格式错误：" + line, true);
+                continue;
+            }
+        } catch (const std::invalid_argument& e) {
+            skip(line_number, std::string("验证失败：") + e.what(), true);
+            continue;
+        }
+        for (const auto& item : skipped_scores) {
+            skip(line_number, "跳过无效成绩：" + item, false);
+        }
+        if (columns.is_all() && !student.is_valid()) {
+            skip(line_number, "无效学生数据：" + student.get_id(), true);
+            continue;
+        }
+        
+        ids.claim(student.get_id_key(), (file_index << 32) | line_number);
+        parsed.students.push_back(std::move(student));
+        parsed.lines.push_back(line_number);
+    }
+    if (file.failed()) skip(0, "读取文件失败", false);
+    return parsed;
+}
+
+/**
+ * @brief 在线程池中并发解析多个名册文件
+ * @param filenames 文件名列表
+ * @param ids 各文件共享的学号集合
+ * @param threads 线程数，0表示按硬件并发数
+ * @param columns 需要解析的列
+ * @return std::vector<ParsedFile> 各文件的解析结果
+ */
+std::vector<ParsedFile> parse_roster_files(const std::vector<std::string>& filenames, ConcurrentIdSet& ids, size_t threads,
+                                           const ColumnSet& columns) {
+    std::vector<ParsedFile> parsed(filenames.size());
+    ThreadPool pool(std::min(threads == 0 ? std::thread::hardware_concurrency() : threads,
+                             std::max<size_t>(1, filenames.size())));
+    std::vector<std::future<void>> done;
+    for (size_t i = 0; i < filenames.size(); ++i) {
+        done.push_back(pool.submit([&filenames, &parsed, &ids, &columns, i]() {
+            parsed[i] = parse_roster_file(filenames[i], i, ids, columns);
+        }));
+    }
+    for (auto& task : done) task.get();
+    return parsed;
+}
+
+/**
+ * @brief 按文件顺序合并解析结果，跳过重复学号并汇总问题
+ * @param filenames 文件名列表
+ * @param parsed 各文件的解析结果（学生被移出）
+ * @param ids 解析时声明学号的集合
+ * @param report 汇总报告（累加）
+ * @param logger 记录无法打开的文件
+ * @param insert 插入一名学生
+ */
+void merge_roster_files(const std::vector<std::string>& filenames, std::vector<ParsedFile>& parsed,
+                        const ConcurrentIdSet& ids, LoadReport& report, Logger& logger,
+                        const std::function<void(Student)>& insert) {
+    for (size_t i = 0; i < parsed.size(); ++i) {
+        ParsedFile& file = parsed[i];
+        if (!file.opened) {
+            logger.error("无法打开文件进行加载：" + filenames[i]);
+            report.files_failed++;
+            report.issues.push_back({filenames[i], 0, "无法打开文件"});
+            continue;
+        }
+        if (file.corrupt_blocks > 0) {
+            logger.error("数据文件校验失败，" + std::to_string(file.corrupt_blocks) + " 块损坏，未加载：" + filenames[i]);
+            report.files_failed++;
+            report.issues.push_back({filenames[i], 0, "校验失败：" + std::to_string(file.corrupt_blocks) + " 块损坏"});
+            continue;
+        }
+        report.files_loaded++;
+        report.invalid += file.invalid;
+        
+        for (size_t j = 0; j < file.students.size(); ++j) {
+            uint64_t rank = (static_cast<uint64_t>(i) << 32) | file.lines[j];
+            uint64_t owner = rank;
+            ids.owner(file.students[j].get_id_key(), owner);
+            if (owner != rank) {
+                file.issues.push_back({filenames[i], file.lines[j],
+                                       "学号重复：" + file.students[j].get_id() + "（保留" +
+                                       filenames[owner >> 32] + "第" + std::to_string(owner & 0xffffffffu) + "行）"});
+                report.duplicates++;
+                continue;
+            }
+            insert(std::move(file.students[j]));
+            report.loaded++;
+        }
+        
+        std::stable_sort(file.issues.begin(), file.issues.end(),
+                         [](const LoadIssue& a, const LoadIssue& b) { return a.line < b.line; });
+        std::move(file.issues.begin(), file.issues.end(), std::back_inserter(report.issues));
+    }
+}
+
+} // namespace
 
 StudentManagementSystem::StudentManagementSystem() : logger_("StudentManagementSystem") {
     logger_.info("学生管理系统初始化完成");
 }
 
+StudentManagementSystem::StudentIter StudentManagementSystem::find_iter(const std::string& student_id) {
+    StudentId key;
+    if (!StudentId::parse(student_id, key)) return students_.end();
+    return find_iter(key);
+}
+
+StudentManagementSystem::StudentIter StudentManagementSystem::find_iter(const StudentId& key) {
+    if (frozen_) {
+        // 冻结期间由最小完美哈希定位槽位，一次探测即可
+        long slot = frozen_->find_slot(key);
+        return slot < 0 ? students_.end() : frozen_slots_[static_cast<size_t>(slot)];
+    }
+    
+    if (!id_filter_.may_contain(StudentIdHash()(key))) return students_.end();
+    
+    const StudentIter* it = id_index_.find(key);
+    if (!it) {
+        id_filter_.record_false_positive();
+        return students_.end();
+    }
+    return *it;
+}
+
+bool StudentManagementSystem::contains_id(const StudentId& key) const {
+    if (frozen_) return frozen_->find_slot(key) >= 0;
+    if (!id_filter_.may_contain(StudentIdHash()(key))) return false;
+    
+    if (!id_index_.contains(key)) {
+        id_filter_.record_false_positive();
+        return false;
+    }
+    return true;
+}
+
+void StudentManagementSystem::rebuild_id_filter() {
+    id_filter_.reset(std::max<size_t>(1024, id_index_.size() * 2));
+    id_index_.for_each([this](const StudentId& key, const StudentIter&) {
+        id_filter_.insert(StudentIdHash()(key));
+    });
+}
+
+void StudentManagementSystem::rebuild_indexes() {
+    id_prefix_.clear();
+    name_prefix_.clear();
+    name_search_.clear();
+    name_ids_.clear();
+    score_ranks_.clear();
+    for (const auto& student : students_) {
+        id_prefix_.insert(student.get_id());
+        name_prefix_.insert(student.get_name());
+        name_search_.insert(student.get_name());
+        name_ids_[student.get_name()].insert(student.get_id_key());
+        score_ranks_.insert(student);
+    }
+    rebuild_id_filter();
+    for (auto& pages : page_indexes_) pages.reset();
+}
+
+const PageIndex& StudentManagementSystem::page_index(StudentSortKey key) const {
+    // 写操作持有独占锁时不会有读者，这里只需让同时分页的读者不重复建立
+    std::lock_guard<std::mutex> guard(page_indexes_mutex_);
+    auto& pages = page_indexes_[static_cast<size_t>(key)];
+    if (!pages) {
+        pages = std::make_unique<PageIndex>(key);
+        pages->build(students_);
+    }
+    return *pages;
+}
+
+bool StudentManagementSystem::restore_indexes(const IndexFile& index, const std::string& filename) {
+    uint64_t checksum = 0;
+    uint64_t size = 0;
+    if (!IndexFile::checksum_file(filename, checksum, size) || !index.matches(checksum, size, students_.size())) {
+        return false;
+    }
+    
+    const char* data = nullptr;
+    size_t length = 0;
+    bool restored = index.section(IndexFile::ID_PREFIX, data, length) && id_prefix_.deserialize(data, length) &&
+                    index.section(IndexFile::NAME_PREFIX, data, length) && name_prefix_.deserialize(data, length) &&
+                    index.section(IndexFile::ID_FILTER, data, length) && id_filter_.deserialize(data, length) &&
+                    index.section(IndexFile::NAME_SEARCH, data, length) && name_search_.deserialize(data, length);
+    if (!restored) return false;
+    
+    // 姓名->学号表和成绩排名只是哈希表插入和树状数组更新，不值得持久化
+    name_ids_.clear();
+    score_ranks_.clear();
+    for (const auto& student : students_) {
+        name_ids_[student.get_name()].insert(student.get_id_key());
+        score_ranks_.insert(student);
+    }
+    for (auto& pages : page_indexes_) pages.reset();
+    return true;
+}
+
+bool StudentManagementSystem::save_index_file(const std::string& filename) const {
+    uint64_t checksum = 0;
+    uint64_t size = 0;
+    if (!IndexFile::checksum_file(filename, checksum, size)) return false;
+    
+    std::vector<std::pair<uint32_t, std::string>> sections(4);
+    sections[0].first = IndexFile::ID_PREFIX;
+    id_prefix_.serialize(sections[0].second);
+    sections[1].first = IndexFile::NAME_PREFIX;
+    name_prefix_.serialize(sections[1].second);
+    sections[2].first = IndexFile::ID_FILTER;
+    id_filter_.serialize(sections[2].second);
+    sections[3].first = IndexFile::NAME_SEARCH;
+    name_search_.serialize(sections[3].second);
+    return IndexFile::write(IndexFile::path_for(filename), checksum, size, students_.size(), sections);
+}
+
+bool StudentManagementSystem::verify_data_file(const std::string& filename) {
+    BlockChecksums checksums;
+    if (!checksums.read(BlockChecksums::path_for(filename))) return true;
+    if (!checksums.matches(filename)) {
+        logger_.info("数据文件在保存后被修改过，跳过块校验：" + filename);
+        return true;
+    }
+    
+    std::vector<uint64_t> bad_blocks;
+    if (checksums.verify(filename, bad_blocks)) return true;
+    
+    // 列出前几个损坏块的字节范围，便于定位
+    constexpr size_t MAX_LISTED = 5;
+    std::string ranges;
+    for (size_t i = 0; i < bad_blocks.size() && i < MAX_LISTED; ++i) {
+        uint64_t begin = bad_blocks[i] * BlockChecksums::BLOCK_SIZE;
+        uint64_t end = std::min<uint64_t>(begin + BlockChecksums::BLOCK_SIZE, checksums.data_size());
+        ranges += (i > 0 ? "、" : "") + std::to_string(begin) + "-" + std::to_string(end);
+    }
+    if (bad_blocks.size() > MAX_LISTED) ranges += "……";
+    logger_.error("数据文件校验失败，" + std::to_string(bad_blocks.size()) + " 块损坏（字节 " + ranges +
+                  "），未加载：" + filename);
+    return false;
+}
+
+void StudentManagementSystem::add_to_indexes(const Student& student) {
+    // 过滤器不支持删除，插入数（含已删除学号）达到容量时按当前学号集合重建
+    if (id_filter_.size() >= id_filter_.capacity()) {
+        rebuild_id_filter();
+    }
+    std::string id = student.get_id();
+    id_filter_.insert(StudentIdHash()(student.get_id_key()));
+    id_prefix_.insert(id);
+    name_prefix_.insert(student.get_name());
+    name_search_.insert(student.get_name());
+    name_ids_[student.get_name()].insert(student.get_id_key());
+    score_ranks_.insert(student);
+    for (auto& pages : page_indexes_) {
+        if (pages) pages->insert(student);
+    }
+}
+
+void StudentManagementSystem::remove_from_indexes(const Student& student) {
+    // 已删除学号过多会抬高假阳性率，残留学号数超过存活学号数时重建
+    if (id_filter_.size() >= 1024 && id_filter_.size() > 2 * id_index_.size()) {
+        rebuild_id_filter();
+    }
+    std::string id = student.get_id();
+    id_prefix_.erase(id);
+    name_prefix_.erase(student.get_name());
+    name_search_.erase(student.get_name());
+    
+    auto ids = name_ids_.find(student.get_name());
+    if (ids != name_ids_.end()) {
+        ids->second.erase(student.get_id_key());
+        if (ids->second.empty()) name_ids_.erase(ids);
+    }
+    score_ranks_.erase(student);
+    for (auto& pages : page_indexes_) {
+        if (pages) pages->erase(student);
+    }
+}
+
+void StudentManagementSystem::insert_record(Student student) {
+    if (!suppress_history_) {
+        UndoRecord record;
+        record.kind = UndoKind::INSERT;
+        record.student_id = student.get_id();
+        history_.record(std::move(record));
+    }
+    
+    if (!defer_indexes_) add_to_indexes(student);
+    students_.push_back(std::move(student));
+    id_index_.insert_or_assign(students_.back().get_id_key(), std::prev(students_.end()));
+    record_changed(students_.back().get_id_key());
+    
+    // 整体加载期间不逐条发布，加载完成后由publish_snapshot一次发布
+    if (bulk_load_) return;
+    changes_.publish_with([this] {
+        ChangeEvent event;
+        event.type = ChangeType::ADD;
+        event.student_id = students_.back().get_id();
+        event.student = students_.back();
+        return event;
+    });
+}
+
+void StudentManagementSystem::erase_record(StudentIter it) {
+    Student removed = detach_record(it);
+    
+    if (!suppress_history_) {
+        UndoRecord record;
+        record.kind = UndoKind::ERASE;
+        record.student_id = removed.get_id();
+        record.detached = std::make_unique<Student>(std::move(removed));
+        history_.record(std::move(record));
+    }
+}
+
+Student StudentManagementSystem::detach_record(StudentIter it) {
+    id_index_.erase(it->get_id_key());
+    remove_from_indexes(*it);
+    Student removed = std::move(*it);
+    students_.erase(it);
+    record_changed(removed.get_id_key());
+    changes_.publish_with([&removed] {
+        ChangeEvent event;
+        event.type = ChangeType::DELETE;
+        event.student_id = removed.get_id();
+        return event;
+    });
+    return removed;
+}
+
+void StudentManagementSystem::replace_record(StudentIter it, Student student) {
+    if (!suppress_history_) {
+        history_.record(UndoHistory::make_update(*it, student));
+    }
+    
+    remove_from_indexes(*it);
+    add_to_indexes(student);
+    
+    StudentId old_key = it->get_id_key();
+    if (student.get_id_key() != old_key) {
+        id_index_.erase(old_key);
+        id_index_.insert_or_assign(student.get_id_key(), it);
+    }
+    *it = std::move(student);
+    if (it->get_id_key() != old_key) record_changed(old_key);
+    record_changed(it->get_id_key());
+    changes_.publish_with([it, &old_key] {
+        ChangeEvent event;
+        event.type = ChangeType::UPDATE;
+        event.student_id = old_key.to_string();
+        event.student = *it;
+        return event;
+    });
+}
+
+void StudentManagementSystem::set_record_score(StudentIter it, const std::string& subject, float score) {
+    float old_score = it->get_score(subject);
+    auto& by_average = page_indexes_[static_cast<size_t>(StudentSortKey::AVERAGE_SCORE)];
+    score_ranks_.erase(*it);
+    if (by_average) by_average->erase(*it);
+    it->set_score(subject, score);
+    score_ranks_.insert(*it);
+    if (by_average) by_average->insert(*it);
+    record_changed(it->get_id_key());
+    
+    if (!suppress_history_) {
+        UndoRecord record;
+        record.kind = UndoKind::SCORE;
+        record.student_id = it->get_id();
+        record.scores.push_back({subject, old_score, score});
+        history_.record(std::move(record));
+    }
+    
+    changes_.publish_with([it, &subject, score] {
+        ChangeEvent event;
+        event.type = ChangeType::SCORE_SET;
+        event.student_id = it->get_id();
+        event.subject = subject;
+        event.score = score;
+        return event;
+    });
+}
+
+void StudentManagementSystem::record_changed(const StudentId& key) {
+    // 全部段都要重写时不必逐个记录（整体加载期间即是如此）
+    if (!segments_all_dirty_) dirty_segments_.insert(SegmentManifest::segment_of(key));
+    
+    if (!log_store_.is_open() || replaying_log_) return;
+    // 直接查学号索引：整体加载期间布隆过滤器尚未更新
+    const StudentIter* it = id_index_.find(key);
+    if (!(it ? log_store_.put(**it) : log_store_.erase(key))) {
+        logger_.error("写入日志结构存储失败：" + key.to_string());
+    }
+}
+
+void StudentManagementSystem::clear_records() {
+    students_.clear();
+    id_index_.clear();
+    id_prefix_.clear();
+    name_prefix_.clear();
+    name_search_.clear();
+    name_ids_.clear();
+    score_ranks_.clear();
+    for (auto& pages : page_indexes_) pages.reset();
+    id_filter_.reset(id_filter_.capacity());
+    history_.clear();
+    segments_all_dirty_ = true;
+    dirty_segments_.clear();
+    loaded_columns_ = ColumnSet::all();
+    if (log_store_.is_open() && !replaying_log_ && !log_store_.clear()) {
+        logger_.error("写入日志结构存储失败：清空");
+    }
+    
+    changes_.publish_with([] {
+        ChangeEvent event;
+        event.type = ChangeType::CLEAR;
+        return event;
+    });
+}
+
+void StudentManagementSystem::revert_record(UndoRecord& record) {
+    switch (record.kind) {
+        case UndoKind::INSERT:
+            record.detached = std::make_unique<Student>(detach_record(find_iter(record.student_id)));
+            break;
+        case UndoKind::ERASE:
+            insert_record(std::move(*record.detached));
+            record.detached.reset();
+            break;
+        case UndoKind::UPDATE:
+        case UndoKind::SCORE:
+            apply_deltas(record, true);
+            break;
+    }
+}
+
+void StudentManagementSystem::reapply_record(UndoRecord& record) {
+    switch (record.kind) {
+        case UndoKind::INSERT:
+            insert_record(std::move(*record.detached));
+            record.detached.reset();
+            break;
+        case UndoKind::ERASE:
+            record.detached = std::make_unique<Student>(detach_record(find_iter(record.student_id)));
+            break;
+        case UndoKind::UPDATE:
+        case UndoKind::SCORE:
+            apply_deltas(record, false);
+            break;
+    }
+}
+
+void StudentManagementSystem::apply_deltas(const UndoRecord& record, bool to_old) {
+    // record.student_id为修改后的学号；重做时学生仍使用修改前的学号
+    std::string current_id = record.student_id;
+    if (!to_old) {
+        for (const auto& delta : record.fields) {
+            if (delta.field == StudentField::ID) current_id = delta.old_value;
+        }
+    }
+    auto it = find_iter(current_id);
+    StudentId current_key = it->get_id_key();
+    
+    remove_from_indexes(*it);
+    for (const auto& delta : record.fields) {
+        set_student_field(*it, delta.field, to_old ? delta.old_value : delta.new_value);
+    }
+    for (const auto& delta : record.scores) {
+        float score = to_old ? delta.old_score : delta.new_score;
+        if (score < 0) {
+            it->remove_score(delta.subject);
+        } else {
+            it->set_score(delta.subject, score);
+        }
+    }
+    if (it->get_id_key() != current_key) {
+        id_index_.erase(current_key);
+        id_index_.insert_or_assign(it->get_id_key(), it);
+    }
+    add_to_indexes(*it);
+    if (it->get_id_key() != current_key) record_changed(current_key);
+    record_changed(it->get_id_key());
+    
+    changes_.publish_with([&] {
+        ChangeEvent event;
+        event.student_id = current_id;
+        float single_score = record.scores.empty() ? -1.0f :
+                             (to_old ? record.scores[0].old_score : record.scores[0].new_score);
+        if (record.kind == UndoKind::SCORE && single_score >= 0) {
+            event.type = ChangeType::SCORE_SET;
+            event.subject = record.scores[0].subject;
+            event.score = single_score;
+        } else {
+            event.type = ChangeType::UPDATE;
+            event.student = *it;
+        }
+        return event;
+    });
+}
+
+bool StudentManagementSystem::undo() {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (!check_writable("撤销")) return false;
+    std::vector<UndoRecord> records;
+    if (!history_.pop_undo(records)) {
+        logger_.warn("撤销失败：没有可撤销的操作");
+        return false;
+    }
+    
+    {
+        ChangeBatch batch(changes_);
+        LogBatch log_batch(log_store_);
+        suppress_history_ = true;
+        for (auto& record : records) {
+            revert_record(record);
+        }
+        suppress_history_ = false;
+    }
+    
+    logger_.info("撤销完成，恢复了 " + std::to_string(records.size()) + " 条修改");
+    history_.push_redo(records);
+    return true;
+}
+
+bool StudentManagementSystem::redo() {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (!check_writable("重做")) return false;
+    std::vector<UndoRecord> records;
+    if (!history_.pop_redo(records)) {
+        logger_.warn("重做失败：没有可重做的操作");
+        return false;
+    }
+    
+    {
+        ChangeBatch batch(changes_);
+        LogBatch log_batch(log_store_);
+        suppress_history_ = true;
+        for (auto& record : records) {
+            reapply_record(record);
+        }
+        suppress_history_ = false;
+    }
+    
+    logger_.info("重做完成，重新应用了 " + std::to_string(records.size()) + " 条修改");
+    history_.push_undo(records);
+    return true;
+}
+
+Transaction StudentManagementSystem::begin_transaction() const {
+    return Transaction();
+}
+
+void StudentManagementSystem::rollback(Transaction& txn) {
+    txn.ops_.clear();
+    txn.active_ = false;
+}
+
+bool StudentManagementSystem::commit(Transaction& txn) {
+    if (!txn.active_) {
+        logger_.warn("提交事务失败：事务已结束");
+        return false;
+    }
+    txn.active_ = false;
+    
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (!check_writable("提交事务")) return false;
+    
+    // 写集合：只复制事务触及的学生，按当前学号定位
+    struct StagedRecord {
+        std::string original_id;  ///< 原学号（新增学生为空）
+        bool existed;             ///< 提交前是否存在
+        bool deleted;             ///< 是否在事务中被删除
+        Student state;            ///< 事务结束时的状态
+    };
+    std::vector<StagedRecord> staged;
+    std::unordered_map<std::string, size_t> by_current_id;
+    std::unordered_set<std::string> touched_ids;
+    
+    auto lookup = [&](const std::string& id) -> long {
+        auto found = by_current_id.find(id);
+        if (found != by_current_id.end()) return static_cast<long>(found->second);
+        if (touched_ids.count(id) > 0) return -1;  // 已在事务中删除或改号
+        auto it = find_iter(id);
+        if (it == students_.end()) return -1;
+        staged.push_back({id, true, false, *it});
+        by_current_id[id] = staged.size() - 1;
+        touched_ids.insert(id);
+        return static_cast<long>(staged.size() - 1);
+    };
+    
+    size_t step = 0;
+    try {
+        for (const auto& op : txn.ops_) {
+            ++step;
+            long index = op.type == TransactionOpType::ADD ? -1 : lookup(op.student_id);
+            if (op.type != TransactionOpType::ADD && index < 0) {
+                throw std::invalid_argument("学号 " + op.student_id + " 不存在");
+            }
+            
+            switch (op.type) {
+                case TransactionOpType::ADD:
+                    if (!op.student.is_valid()) throw std::invalid_argument("学生信息不完整");
+                    if (lookup(op.student_id) >= 0) {
+                        throw std::invalid_argument("学号 " + op.student_id + " 已存在");
+                    }
+                    staged.push_back({"", false, false, op.student});
+                    by_current_id[op.student_id] = staged.size() - 1;
+                    break;
+                case TransactionOpType::UPDATE:
+                    if (!op.student.is_valid()) throw std::invalid_argument("新学生信息不完整");
+                    if (op.student.get_id() != op.student_id && lookup(op.student.get_id()) >= 0) {
+                        throw std::invalid_argument("新学号 " + op.student.get_id() + " 已存在");
+                    }
+                    staged[index].state = op.student;
+                    by_current_id.erase(op.student_id);
+                    by_current_id[op.student.get_id()] = static_cast<size_t>(index);
+                    break;
+                case TransactionOpType::DELETE:
+                    staged[index].deleted = true;
+                    by_current_id.erase(op.student_id);
+                    break;
+                case TransactionOpType::SET_SCORE:
+                    staged[index].state.set_score(op.value, op.score);
+                    break;
+                case TransactionOpType::SET_CLASS:
+                    staged[index].state.set_class_id(op.value);
+                    break;
+            }
+        }
+    } catch (const std::invalid_argument& e) {
+        logger_.warn("提交事务失败：第 " + std::to_string(step) + " 个操作无效 (" + e.what() + ")，事务未做任何修改");
+        return false;
+    }
+    
+    // 一次性应用写集合：先删除（含改号学生的旧记录）释放学号，再原地替换，最后插入
+    ChangeBatch batch(changes_);
+    LogBatch log_batch(log_store_);
+    history_.begin_group();
+    for (auto& record : staged) {
+        if (record.existed && (record.deleted || record.state.get_id() != record.original_id)) {
+            erase_record(find_iter(record.original_id));
+        }
+    }
+    for (auto& record : staged) {
+        if (record.existed && !record.deleted && record.state.get_id() == record.original_id) {
+            auto it = find_iter(record.original_id);
+            if (*it != record.state) replace_record(it, std::move(record.state));
+        }
+    }
+    for (auto& record : staged) {
+        if (!record.deleted && (!record.existed || record.state.get_id() != record.original_id)) {
+            insert_record(std::move(record.state));
+        }
+    }
+    history_.end_group();
+    
+    logger_.info("事务提交成功，共 " + std::to_string(txn.ops_.size()) + " 个操作，影响 " +
+                 std::to_string(staged.size()) + " 名学生");
+    txn.ops_.clear();
+    return true;
+}
+
+ChangeStream& StudentManagementSystem::change_stream() {
+    return changes_;
+}
+
+void StudentManagementSystem::set_log_level(LogLevel level) {
+    logger_.set_level(level);
+}
+
+void StudentManagementSystem::set_direct_io(bool enabled) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    direct_io_ = enabled;
+}
+
 bool StudentManagementSystem::add_student(const Student& student) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (!check_writable("添加学生")) return false;
     if (!student.is_valid()) {
         logger_.warn("添加学生失败：学生信息不完整");
         return false;
     }
-    
-    // 检查学号是否重复
-    auto it = std::find_if(students_.begin(), students_.end(),
-        [&student](const Student& s) {
-            return s.get_id() == student.get_id();
-        });
-    
-    if (it != students_.end()) {
-        logger_.warn("添加学生失败：学号 " + student.get_id() + " 已存在");
+    
+    // 检查学号是否重复
+    if (contains_id(student.get_id_key())) {
+        logger_.warn("添加学生失败：学号 " + student.get_id() + " 已存在");
+        return false;
+    }
+    
+    insert_record(student);
+    logger_.info("成功添加学生：" + student.get_id() + " - " + student.get_name());
+    return true;
+}
+
+bool StudentManagementSystem::delete_student(const std::string& student_id) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (!check_writable("删除学生")) return false;
+    auto it = find_iter(student_id);
+    
+    if (it == students_.end()) {
+        logger_.warn("删除学生失败：学号 " + student_id + " 不存在");
+        return false;
+    }
+    
+    erase_record(it);
+    logger_.info("成功删除学生：" + student_id);
+    return true;
+}
+
+bool StudentManagementSystem::update_student(const std::string& student_id, const Student& new_student) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (!check_writable("修改学生")) return false;
+    auto it = find_iter(student_id);
+    
+    if (it == students_.end()) {
+        logger_.warn("修改学生失败：学号 " + student_id + " 不存在");
+        return false;
+    }
+    
+    if (!new_student.is_valid()) {
+        logger_.warn("修改学生失败：新学生信息不完整");
+        return false;
+    }
+    
+    // 学号变更时需要保证新学号唯一
+    if (new_student.get_id_key() != it->get_id_key() && contains_id(new_student.get_id_key())) {
+        logger_.warn("修改学生失败：新学号 " + new_student.get_id() + " 已存在");
+        return false;
+    }
+    
+    replace_record(it, new_student);
+    logger_.info("成功修改学生信息：" + student_id);
+    return true;
+}
+
+bool StudentManagementSystem::find_student_by_id(const std::string& student_id, Student& student) {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = find_iter(student_id);
+    if (it == students_.end()) return false;
+    student = *it;
+    return true;
+}
+
+bool StudentManagementSystem::has_student(const std::string& student_id) {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return find_iter(student_id) != students_.end();
+}
+
+size_t StudentManagementSystem::find_students_by_ids(const std::vector<std::string>& student_ids,
+                                                     const std::function<void(size_t index, const Student& student)>& visit) {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    size_t found = 0;
+    
+    if (frozen_) {
+        for (size_t i = 0; i < student_ids.size(); ++i) {
+            auto it = find_iter(student_ids[i]);
+            if (it == students_.end()) continue;
+            visit(i, *it);
+            found++;
+        }
+        return found;
+    }
+    
+    std::vector<StudentId> keys(student_ids.size());
+    std::vector<uint64_t> hashes(student_ids.size());
+    for (size_t i = 0; i < student_ids.size(); ++i) {
+        if (StudentId::parse(student_ids[i], keys[i])) hashes[i] = FlatIdMap<StudentIter>::hash_of(keys[i]);
+    }
+    
+    // 两级流水：访问第i个学生时，第i+DISTANCE个学号的槽位正在预取，
+    // 第i+RESOLVE个学号已查到槽位、其学生记录（链表节点）正在预取。
+    // 批量查找的键通常都存在，不经过布隆过滤器
+    constexpr size_t DISTANCE = 16;
+    constexpr size_t RESOLVE = DISTANCE / 2;
+    std::vector<const Student*> records(student_ids.size(), nullptr);
+    auto resolve = [&](size_t k) {
+        if (keys[k].length == 0) return;
+        const StudentIter* it = id_index_.find(keys[k], hashes[k]);
+        if (it) {
+            records[k] = &**it;
+            prefetch_read(records[k]);
+        }
+    };
+    for (size_t k = 0; k < DISTANCE && k < student_ids.size(); ++k) {
+        if (keys[k].length != 0) id_index_.prefetch(hashes[k]);
+    }
+    for (size_t k = 0; k < RESOLVE && k < student_ids.size(); ++k) resolve(k);
+    for (size_t i = 0; i < student_ids.size(); ++i) {
+        if (i + DISTANCE < student_ids.size() && keys[i + DISTANCE].length != 0) {
+            id_index_.prefetch(hashes[i + DISTANCE]);
+        }
+        if (i + RESOLVE < student_ids.size()) resolve(i + RESOLVE);
+        if (records[i]) {
+            visit(i, *records[i]);
+            found++;
+        }
+    }
+    return found;
+}
+
+std::vector<Student> StudentManagementSystem::find_students_by_name(const std::string& name) {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    std::vector<Student> result;
+    
+    for (const auto& student : students_) {
+        if (student.get_name().find(name) != std::string::npos) {
+            result.push_back(student);
+        }
+    }
+    
+    return result;
+}
+
+StudentList StudentManagementSystem::get_all_students() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return students_;
+}
+
+void StudentManagementSystem::for_each_student(const std::function<void(const Student& student)>& visit) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    for (const auto& student : students_) visit(student);
+}
+
+size_t StudentManagementSystem::get_student_count() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return students_.size();
+}
+
+BloomFilterStats StudentManagementSystem::id_filter_stats() const {
+    return id_filter_.stats();
+}
+
+void StudentManagementSystem::clear_all_students() {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (!check_writable("清空数据")) return;
+    clear_records();
+    logger_.info("清空所有学生数据");
+}
+
+bool StudentManagementSystem::write_data_file(const std::string& filename, const std::vector<const Student*>& records) const {
+    FileWriter file;
+    if (!file.open(filename, direct_io_)) {
+        logger_.error("无法打开文件进行保存：" + filename);
+        return false;
+    }
+    
+    // 添加表头（包含成绩字段标识）
+    constexpr size_t FLUSH_BYTES = 64 * 1024;
+    std::string buffer = csv_header();
+    buffer.reserve(FLUSH_BYTES + 1024);
+    
+    // 每积累约64KB交给写出器，写满的块在后台落盘，与后续行的编码重叠；块校验和随写随算
+    BlockChecksums checksums;
+    for (const Student* record : records) {
+        append_student_csv(buffer, *record);
+        if (buffer.size() >= FLUSH_BYTES) {
+            checksums.update(buffer.data(), buffer.size());
+            file.write(buffer);
+            buffer.clear();
+        }
+    }
+    checksums.update(buffer.data(), buffer.size());
+    file.write(buffer);
+    
+    if (!file.close()) {
+        logger_.error("写入文件失败：" + filename);
+        return false;
+    }
+    if (!checksums.write(BlockChecksums::path_for(filename), filename)) {
+        logger_.warn("校验文件写入失败，下次加载时不做块校验：" + BlockChecksums::path_for(filename));
+    }
+    return true;
+}
+
+bool StudentManagementSystem::save_to_file(const std::string& filename) {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (!check_all_columns("保存数据")) return false;
+    std::vector<const Student*> records;
+    records.reserve(students_.size());
+    for (const auto& student : students_) records.push_back(&student);
+    if (!write_data_file(filename, records)) return false;
+    
+    if (!save_index_file(filename)) {
+        logger_.warn("索引文件写入失败，下次加载时将重新构建索引：" + IndexFile::path_for(filename));
+    }
+    logger_.info("成功保存数据到文件：" + filename);
+    return true;
+}
+
+bool StudentManagementSystem::save_segments(const std::string& filename, size_t& rewritten) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    rewritten = 0;
+    if (!check_all_columns("分段保存")) return false;
+    
+    // 换了清单或整体重新加载过时全部重写，并以磁盘上原有的清单为准清理旧文件
+    bool full = segments_all_dirty_ || filename != segment_manifest_;
+    if (!full && dirty_segments_.empty()) {
+        logger_.info("分段保存：没有修改过的段：" + filename);
+        return true;
+    }
+    SegmentManifest previous;
+    if (full) {
+        previous.load(filename);
+    } else {
+        previous = segments_;
+    }
+    
+    std::map<std::string, std::vector<const Student*>> groups;
+    for (const auto& student : students_) {
+        std::string segment = SegmentManifest::segment_of(student.get_id_key());
+        if (full || dirty_segments_.count(segment)) groups[segment].push_back(&student);
+    }
+    
+    SegmentManifest manifest;
+    manifest.generation = previous.generation + 1;
+    if (!full) {
+        manifest.segments = previous.segments;
+        for (const auto& segment : dirty_segments_) manifest.segments.erase(segment);
+    }
+    
+    std::error_code error;
+    std::filesystem::create_directories(SegmentManifest::directory_for(filename), error);
+    
+    // 各段写成新代号的文件，旧文件在清单替换之后才删除
+    std::vector<std::string> written;
+    bool success = true;
+    for (const auto& [segment, students] : groups) {
+        SegmentEntry entry;
+        entry.file = SegmentManifest::file_for(filename, segment, manifest.generation);
+        entry.count = students.size();
+        std::string path = SegmentManifest::resolve(filename, entry.file);
+        
+        FileWriter file;
+        if (!file.open(path)) {
+            success = false;
+            break;
+        }
+        written.push_back(path);
+        std::string buffer = csv_header();
+        for (const Student* student : students) append_student_csv(buffer, *student);
+        file.write(buffer);
+        entry.size = buffer.size();
+        entry.crc = crc32c(buffer.data(), buffer.size());
+        entry.has_crc = true;
+        if (!file.close()) {
+            success = false;
+            break;
+        }
+        manifest.segments[segment] = std::move(entry);
+    }
+    if (success) success = manifest.save(filename);
+    if (!success) {
+        for (const auto& path : written) std::remove(path.c_str());
+        logger_.error("分段保存失败：" + filename);
+        return false;
+    }
+    
+    // 删除被替换或已清空的段的旧文件
+    for (const auto& [segment, entry] : previous.segments) {
+        auto it = manifest.segments.find(segment);
+        if (it == manifest.segments.end() || it->second.file != entry.file) {
+            std::remove(SegmentManifest::resolve(filename, entry.file).c_str());
+            if (it == manifest.segments.end()) ++rewritten;
+        }
+    }
+    rewritten += groups.size();
+    
+    segments_ = std::move(manifest);
+    segment_manifest_ = filename;
+    dirty_segments_.clear();
+    segments_all_dirty_ = false;
+    logger_.info("分段保存完成：重写 " + std::to_string(rewritten) + " 个段，共 " +
+                 std::to_string(segments_.segments.size()) + " 个段：" + filename);
+    return true;
+}
+
+bool StudentManagementSystem::is_csv_header(const std::string& line) const {
+    // 检查是否是表头（包含"学号"等字段）
+    if (line.find(student_schema::IdField::LABEL) == std::string::npos) return false;
+    logger_.info("检测到Excel表头，已跳过");
+    return true;
+}
+
+bool StudentManagementSystem::parse_csv_line(const std::string& line, Student& student, const ColumnSet& columns) const {
+    std::vector<std::string> skipped_scores;
+    bool ok = student_from_csv(line, student, &skipped_scores, columns);
+    for (const auto& item : skipped_scores) {
+        logger_.warn("跳过无效成绩：" + item);
+    }
+    return ok;
+}
+
+bool StudentManagementSystem::load_from_file(const std::string& filename, const ColumnSet& columns) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (!check_writable("加载数据") || !check_load_columns(columns)) return false;
+    FileReader file;
+    if (!file.open(filename, direct_io_)) {
+        logger_.error("无法打开文件进行加载：" + filename);
+        return false;
+    }
+    
+    std::string line;
+    bool has_line = file.read_line(line);
+    if (has_line && line == SegmentManifest::MAGIC) {
+        file.close();
+        return load_segments(filename, columns);
+    }
+    if (!verify_data_file(filename)) return false;
+    
+    // 有索引文件时先只建学号索引，加载完成后再决定恢复还是重建其余索引；
+    // 只加载部分列时索引文件中的姓名等与名册不符，不使用
+    IndexFile index;
+    bool has_index = columns.is_all() && index.open(IndexFile::path_for(filename));
+    
+    // 整体重新加载作为一个批次发布（CLEAR后一个SNAPSHOT，日志中逐行写出加载的学生）
+    ChangeBatch batch(changes_);
+    LogBatch log_batch(log_store_);
+    clear_records();
+    loaded_columns_ = columns;
+    if (!columns.is_all()) logger_.info("只加载以下列：" + columns.to_string());
+    suppress_history_ = true;
+    bulk_load_ = true;
+    defer_indexes_ = has_index;
+    int count = 0;
+    int error_count = 0;
+    
+    // 后续块在解析当前块期间预读
+    for (bool first = true; has_line; has_line = file.read_line(line), first = false) {
+        if (line.empty() || (first && is_csv_header(line))) continue;
+        
+        Student student;
+        try {
+            if (!parse_csv_line(line, student, columns)) {
+                logger_.warn("跳过格式错误的行：" + line);
+                error_count++;
+                continue;
+            }
+        } catch (const std::invalid_argument& e) {
+            logger_.warn("加载学生数据时跳过验证失败的数据：" + line + " (" + e.what() + ")");
+            error_count++;
+            continue;
+        }
+        
+        // 只加载部分列时未加载的必填字段为空，已加载的字段在解析时已验证
+        if (columns.is_all() && !student.is_valid()) {
+            logger_.warn("跳过无效学生数据：" + student.get_id() + " - " + student.get_name());
+            error_count++;
+        } else if (id_index_.contains(student.get_id_key())) {
+            logger_.warn("跳过重复学号：" + student.get_id());
+            error_count++;
+        } else {
+            insert_record(std::move(student));
+            count++;
+        }
+    }
+    
+    bool read_failed = file.failed();
+    file.close();
+    suppress_history_ = false;
+    bulk_load_ = false;
+    changes_.publish_snapshot(students_);
+    
+    if (has_index) {
+        defer_indexes_ = false;
+        if (restore_indexes(index, filename)) {
+            logger_.info("已从索引文件恢复索引：" + IndexFile::path_for(filename));
+        } else {
+            rebuild_indexes();
+            logger_.info("索引文件已过期，已重新构建索引：" + IndexFile::path_for(filename));
+        }
+    }
+    
+    if (error_count > 0) {
+        logger_.warn("从文件加载数据完成，成功加载 " + std::to_string(count) +
+                     " 个学生，跳过 " + std::to_string(error_count) + " 个无效数据：" + filename);
+    } else {
+        logger_.info("从文件加载了 " + std::to_string(count) + " 个学生数据：" + filename);
+    }
+    if (read_failed) {
+        logger_.error("读取文件失败，只加载了出错位置之前的数据：" + filename);
         return false;
     }
     
-    students_.push_back(student);
-    logger_.info("成功添加学生：" + student.get_id() + " - " + student.get_name());
-    return true;
+    return count > 0;
 }
 
-bool StudentManagementSystem::delete_student(const std::string& student_id) {
-    auto it = std::find_if(students_.begin(), students_.end(),
-        [&student_id](const Student& student) {
-            return student.get_id() == student_id;
-        });
+bool StudentManagementSystem::load_from_files(const std::vector<std::string>& filenames, LoadReport& report, size_t threads,
+                                              const ColumnSet& columns) {
+    report = LoadReport();
     
-    if (it == students_.end()) {
-        logger_.warn("删除学生失败：学号 " + student_id + " 不存在");
-        return false;
-    }
+    // 解析只读文件，不访问名册，因此在加锁前并发进行
+    ConcurrentIdSet ids;
+    std::vector<ParsedFile> parsed = parse_roster_files(filenames, ids, threads, columns);
     
-    students_.erase(it);
-    logger_.info("成功删除学生：" + student_id);
-    return true;
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (!check_writable("加载数据") || !check_load_columns(columns)) return false;
+    
+    // 整体重新加载作为一个批次发布（CLEAR后一个SNAPSHOT），合并完成后一次性构建二级索引
+    ChangeBatch batch(changes_);
+    LogBatch log_batch(log_store_);
+    clear_records();
+    loaded_columns_ = columns;
+    if (!columns.is_all()) logger_.info("只加载以下列：" + columns.to_string());
+    suppress_history_ = true;
+    bulk_load_ = true;
+    defer_indexes_ = true;
+    merge_roster_files(filenames, parsed, ids, report, logger_,
+                       [this](Student student) { insert_record(std::move(student)); });
+    suppress_history_ = false;
+    bulk_load_ = false;
+    changes_.publish_snapshot(students_);
+    defer_indexes_ = false;
+    rebuild_indexes();
+    
+    std::string summary = "从 " + std::to_string(report.files_loaded) + " 个文件加载了 " +
+                          std::to_string(report.loaded) + " 个学生";
+    if (report.files_failed + report.invalid + report.duplicates > 0) {
+        logger_.warn(summary + "，" + std::to_string(report.files_failed) + " 个文件无法打开，跳过 " +
+                     std::to_string(report.invalid) + " 个无效数据和 " + std::to_string(report.duplicates) + " 个重复学号");
+    } else {
+        logger_.info(summary);
+    }
+    return report.loaded > 0;
 }
 
-bool StudentManagementSystem::update_student(const std::string& student_id, const Student& new_student) {
-    auto it = std::find_if(students_.begin(), students_.end(),
-        [&student_id](const Student& student) {
-            return student.get_id() == student_id;
-        });
-    
-    if (it == students_.end()) {
-        logger_.warn("修改学生失败：学号 " + student_id + " 不存在");
+bool StudentManagementSystem::load_segments(const std::string& filename, const ColumnSet& columns) {
+    SegmentManifest manifest;
+    if (!manifest.load(filename)) {
+        logger_.error("分段清单格式错误：" + filename);
         return false;
     }
     
-    if (!new_student.is_valid()) {
-        logger_.warn("修改学生失败：新学生信息不完整");
+    std::vector<std::string> files;
+    std::vector<const SegmentEntry*> entries;
+    size_t expected = 0;
+    for (const auto& [name, entry] : manifest.segments) {
+        files.push_back(SegmentManifest::resolve(filename, entry.file));
+        entries.push_back(&entry);
+        expected += entry.count;
+    }
+    
+    // 段文件按清单记录的CRC32C并行校验，有段损坏时不加载、保留现有名册
+    std::vector<char> corrupt(files.size(), 0);
+    {
+        ThreadPool pool(std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()),
+                                         std::max<size_t>(1, files.size())));
+        std::vector<std::future<void>> done;
+        for (size_t i = 0; i < files.size(); ++i) {
+            if (!entries[i]->has_crc) continue;
+            done.push_back(pool.submit([&files, &entries, &corrupt, i]() {
+                uint32_t crc = 0;
+                uint64_t size = 0;
+                corrupt[i] = BlockChecksums::checksum_file(files[i], crc, size) &&
+                             (crc != entries[i]->crc || size != entries[i]->size);
+            }));
+        }
+        for (auto& task : done) task.get();
+    }
+    std::string corrupt_files;
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (corrupt[i]) corrupt_files += (corrupt_files.empty() ? "" : "、") + files[i];
+    }
+    if (!corrupt_files.empty()) {
+        logger_.error("分段文件校验失败，未加载：" + corrupt_files);
         return false;
     }
     
-    *it = new_student;
-    logger_.info("成功修改学生信息：" + student_id);
-    return true;
-}
-
-Student* StudentManagementSystem::find_student_by_id(const std::string& student_id) {
-    auto it = std::find_if(students_.begin(), students_.end(),
-        [&student_id](const Student& student) {
-            return student.get_id() == student_id;
-        });
+    ConcurrentIdSet ids;
+    std::vector<ParsedFile> parsed = parse_roster_files(files, ids, 0, columns);
+    
+    ChangeBatch batch(changes_);
+    LogBatch log_batch(log_store_);
+    clear_records();
+    loaded_columns_ = columns;
+    if (!columns.is_all()) logger_.info("只加载以下列：" + columns.to_string());
+    suppress_history_ = true;
+    bulk_load_ = true;
+    defer_indexes_ = true;
+    LoadReport report;
+    merge_roster_files(files, parsed, ids, report, logger_,
+                       [this](Student student) { insert_record(std::move(student)); });
+    suppress_history_ = false;
+    bulk_load_ = false;
+    changes_.publish_snapshot(students_);
+    defer_indexes_ = false;
+    rebuild_indexes();
     
-    if (it != students_.end()) {
-        return &(*it);
+    for (const auto& issue : report.issues) {
+        logger_.warn("加载分段时跳过：" + issue.filename + "第" + std::to_string(issue.line) + "行：" + issue.message);
     }
-    return nullptr;
+    
+    // 段文件与清单一致时才能继续增量保存，否则下次分段保存重写全部段
+    segments_ = std::move(manifest);
+    segment_manifest_ = filename;
+    if (report.issues.empty() && report.loaded == expected) {
+        segments_all_dirty_ = false;
+    } else {
+        logger_.warn("分段数据与清单不一致，下次分段保存时将重写全部段：" + filename);
+    }
+    
+    logger_.info("从分段清单加载了 " + std::to_string(report.loaded) + " 个学生（" +
+                 std::to_string(files.size()) + " 个段）：" + filename);
+    return report.loaded > 0;
 }
 
-std::list<Student*> StudentManagementSystem::find_students_by_name(const std::string& name) {
-    std::list<Student*> result;
+bool StudentManagementSystem::open_log_store(const std::string& directory) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (!check_writable("打开日志结构存储")) return false;
     
-    for (auto& student : students_) {
-        if (student.get_name().find(name) != std::string::npos) {
-            result.push_back(&student);
+    if (!log_store_.open(directory)) {
+        logger_.error("无法打开日志结构存储：" + directory);
+        return false;
+    }
+    
+    if (log_store_.size() == 0) {
+        // 空存储以当前名册为初始内容
+        if (!check_all_columns("写入日志结构存储")) {
+            log_store_.close();
+            return false;
+        }
+        LogBatch log_batch(log_store_);
+        for (const auto& student : students_) {
+            if (!log_store_.put(student)) {
+                logger_.error("写入日志结构存储失败：" + directory);
+                log_store_.close();
+                return false;
+            }
         }
+        logger_.info("已创建日志结构存储，写入 " + std::to_string(students_.size()) + " 个学生：" + directory);
+        return true;
     }
     
-    return result;
-}
-
-const std::list<Student>& StudentManagementSystem::get_all_students() const {
-    return students_;
+    ChangeBatch batch(changes_);
+    replaying_log_ = true;
+    clear_records();
+    suppress_history_ = true;
+    bulk_load_ = true;
+    defer_indexes_ = true;
+    int count = 0;
+    int error_count = 0;
+    bool read_ok = log_store_.for_each_live([&](const std::string& data) {
+        Student student;
+        try {
+            if (!student_from_binary(data.data(), data.size(), student) || !student.is_valid()) {
+                error_count++;
+                return;
+            }
+        } catch (const std::invalid_argument&) {
+            error_count++;
+            return;
+        }
+        insert_record(std::move(student));
+        count++;
+    });
+    suppress_history_ = false;
+    bulk_load_ = false;
+    changes_.publish_snapshot(students_);
+    defer_indexes_ = false;
+    replaying_log_ = false;
+    rebuild_indexes();
+    
+    if (!read_ok) {
+        logger_.error("读取日志结构存储失败，只加载了出错位置之前的数据：" + directory);
+        log_store_.close();
+        return false;
+    }
+    if (error_count > 0) {
+        logger_.warn("日志结构存储中有 " + std::to_string(error_count) + " 条无效记录已跳过：" + directory);
+    }
+    logger_.info("从日志结构存储加载了 " + std::to_string(count) + " 个学生：" + directory);
+    return true;
 }
 
-size_t StudentManagementSystem::get_student_count() const {
-    return students_.size();
+void StudentManagementSystem::close_log_store() {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    log_store_.close();
 }
 
-void StudentManagementSystem::clear_all_students() {
-    students_.clear();
-    logger_.info("清空所有学生数据");
+LogStoreStats StudentManagementSystem::log_store_stats() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return log_store_.stats();
 }
 
-bool StudentManagementSystem::save_to_file(const std::string& filename) {
-    std::ofstream file(filename);
-    if (!file.is_open()) {
-        logger_.error("无法打开文件进行保存：" + filename);
+bool StudentManagementSystem::upsert_from_file(const std::string& filename, ImportStats& stats) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (!check_writable("增量导入")) return false;
+    FileReader file;
+    if (!file.open(filename, direct_io_)) {
+        logger_.error("无法打开文件进行增量导入：" + filename);
         return false;
     }
+    if (!verify_data_file(filename)) return false;
     
-    // 添加表头（包含成绩字段标识）
-    file << "学号,姓名,性别,班级,电话,邮箱,成绩信息\n";
+    stats = ImportStats();
+    ChangeBatch batch(changes_);
+    LogBatch log_batch(log_store_);
+    // 一次导入作为一个撤销批次
+    history_.begin_group();
+    std::string line;
     
-    for (const auto& student : students_) {
-        file << student.get_id() << ","
-             << student.get_name() << ","
-             << student.get_gender() << ","
-             << student.get_class_id() << ","
-             << student.get_phone() << ","
-             << student.get_email() << ",";
+    for (bool first = true; file.read_line(line); first = false) {
+        if (line.empty() || (first && is_csv_header(line))) continue;
+        
+        // 删除标记：学号列以'-'开头
+        if (line[0] == '-') {
+            std::string id = line.substr(1, line.find(',') - 1);
+            auto it = find_iter(id);
+            if (it == students_.end()) {
+                stats.not_found++;
+            } else {
+                erase_record(it);
+                stats.deleted++;
+            }
+            continue;
+        }
         
-        // 保存成绩信息（格式：科目1:成绩1;科目2:成绩2;...）
-        const auto& scores = student.get_scores();
-        if (!scores.empty()) {
-            bool first = true;
-            for (const auto& [subject, score] : scores) {
-                if (!first) file << ";";
-                file << subject << ":" << score;
-                first = false;
+        Student student;
+        try {
+            if (!parse_csv_line(line, student) || !student.is_valid()) {
+                logger_.warn("增量导入跳过格式错误的行：" + line);
+                stats.invalid++;
+                continue;
             }
+        } catch (const std::invalid_argument& e) {
+            logger_.warn("增量导入跳过验证失败的数据：" + line + " (" + e.what() + ")");
+            stats.invalid++;
+            continue;
+        }
+        
+        auto it = find_iter(student.get_id());
+        if (it == students_.end()) {
+            insert_record(std::move(student));
+            stats.inserted++;
+        } else if (*it != student) {
+            replace_record(it, std::move(student));
+            stats.updated++;
         } else {
-            file << "无成绩";
+            stats.unchanged++;
         }
-        file << "\n";
     }
     
+    if (file.failed()) logger_.error("读取增量文件失败，出错位置之后的数据未导入：" + filename);
     file.close();
-    logger_.info("成功保存数据到文件：" + filename);
+    history_.end_group();
+    
+    logger_.info("增量导入完成：新增 " + std::to_string(stats.inserted) +
+                 "，更新 " + std::to_string(stats.updated) +
+                 "，未变化 " + std::to_string(stats.unchanged) +
+                 "，删除 " + std::to_string(stats.deleted) +
+                 "，删除目标不存在 " + std::to_string(stats.not_found) +
+                 "，无效 " + std::to_string(stats.invalid) + "：" + filename);
     return true;
 }
 
-bool StudentManagementSystem::load_from_file(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        logger_.error("无法打开文件进行加载：" + filename);
+bool StudentManagementSystem::save_to_excel_file(const std::string& filename, const std::vector<SortKey>& order) {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (!check_all_columns("保存Excel")) return false;
+    
+    // 按指定顺序（默认按学号）输出，不改变内存中的顺序；格式、校验文件和索引文件与save_to_file相同。
+    // 索引只记录学号和姓名的集合，与文件中的行序无关
+    if (!write_data_file(filename, sorted_records(order))) return false;
+    if (!save_index_file(filename)) {
+        logger_.warn("索引文件写入失败，下次加载时将重新构建索引：" + IndexFile::path_for(filename));
+    }
+    logger_.info("成功保存Excel格式数据到文件：" + filename);
+    return true;
+}
+
+bool StudentManagementSystem::export_by_class(const std::string& output_dir, size_t& class_count, size_t threads) {
+    class_count = 0;
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (!check_all_columns("按班级导出")) return false;
+    std::error_code error;
+    std::filesystem::create_directories(output_dir, error);
+    if (error) {
+        logger_.error("无法创建导出目录：" + output_dir);
         return false;
     }
     
-    students_.clear();
-    std::string line;
-    int count = 0;
-    int error_count = 0;
+    // 一次遍历按班级分组，班级按首次出现的顺序编号
+    std::unordered_map<std::string, size_t> class_slots;
+    std::vector<std::vector<const Student*>> groups;
+    for (const auto& student : students_) {
+        auto [it, inserted] = class_slots.emplace(student.get_class_id(), groups.size());
+        if (inserted) groups.emplace_back();
+        groups[it->second].push_back(&student);
+    }
     
-    // 跳过Excel表头（如果存在）
-    if (std::getline(file, line)) {
-        // 检查是否是表头（包含"学号"等字段）
-        if (line.find("学号") != std::string::npos) {
-            // 这是表头，跳过
-            logger_.info("检测到Excel表头，已跳过");
-        } else {
-            // 不是表头，重新处理这一行
-            file.seekg(0);
+    // 班级号可以含任意字符，替换掉文件名中不可用的字符；替换后重名的按班级首次出现的顺序加序号区分，
+    // 同一名册每次导出的文件名相同
+    std::vector<std::string> paths(groups.size());
+    std::unordered_set<std::string> used_names;
+    for (size_t slot = 0; slot < groups.size(); ++slot) {
+        std::string name = groups[slot].front()->get_class_id();
+        for (char& ch : name) {
+            if (static_cast<unsigned char>(ch) < 0x20 || std::string("/\\:*?\"<>|").find(ch) != std::string::npos) {
+                ch = '_';
+            }
         }
-    } else {
-        file.seekg(0);
+        std::string unique = name;
+        for (size_t n = 2; !used_names.insert(unique).second; ++n) {
+            unique = name + "_" + std::to_string(n);
+        }
+        paths[slot] = (std::filesystem::path(output_dir) / (unique + ".csv")).string();
     }
     
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
-        
-        std::istringstream iss(line);
-        std::string id, name, gender, class_id, phone, email, scores_str;
-        
-        // 解析CSV行（包含成绩信息）
-        if (std::getline(iss, id, ',') &&
-            std::getline(iss, name, ',') &&
-            std::getline(iss, gender, ',') &&
-            std::getline(iss, class_id, ',') &&
-            std::getline(iss, phone, ',') &&
-            std::getline(iss, email, ',') &&
-            std::getline(iss, scores_str)) {
-            
-            try {
-                // 创建学生对象
-                Student student(id, name, gender, class_id, phone, email);
-                
-                // 解析成绩信息（如果存在）
-                if (scores_str != "无成绩" && !scores_str.empty()) {
-                    std::istringstream scores_stream(scores_str);
-                    std::string subject_score;
-                    
-                    while (std::getline(scores_stream, subject_score, ';')) {
-                        size_t colon_pos = subject_score.find(':');
-                        if (colon_pos != std::string::npos) {
-                            std::string subject = subject_score.substr(0, colon_pos);
-                            std::string score_str = subject_score.substr(colon_pos + 1);
-                            
-                            try {
-                                float score = std::stof(score_str);
-                                student.set_score(subject, score);
-                            } catch (const std::invalid_argument& e) {
-                                logger_.warn("跳过无效成绩：" + subject + "=" + score_str);
-                            }
-                        }
-                    }
-                }
+    // 各班级文件相互独立，由线程池并发编码和写出；共享锁保持到全部写完
+    std::vector<std::future<bool>> results;
+    results.reserve(groups.size());
+    {
+        ThreadPool pool(threads);
+        bool direct = direct_io_;
+        for (size_t i = 0; i < groups.size(); ++i) {
+            results.push_back(pool.submit([&groups, &paths, direct, i]() {
+                std::string buffer = csv_header();
+                for (const Student* student : groups[i]) append_student_csv(buffer, *student);
                 
-                if (student.is_valid()) {
-                    students_.push_back(student);
-                    count++;
-                } else {
-                    logger_.warn("跳过无效学生数据：" + id + " - " + name);
-                    error_count++;
-                }
-            } catch (const std::invalid_argument& e) {
-                logger_.warn("加载学生数据时跳过验证失败的数据：" + id + " - " + name + " (" + e.what() + ")");
-                error_count++;
-            }
-        } else {
-            logger_.warn("跳过格式错误的行：" + line);
-            error_count++;
+                FileWriter file;
+                if (!file.open(paths[i], direct)) return false;
+                file.write(buffer);
+                return file.close();
+            }));
         }
     }
     
-    file.close();
+    bool success = true;
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (results[i].get()) {
+            ++class_count;
+        } else {
+            logger_.error("无法写入班级文件：" + paths[i]);
+            success = false;
+        }
+    }
+    logger_.info("按班级导出 " + std::to_string(class_count) + " 个班级文件到目录：" + output_dir);
+    return success;
+}
+
+void StudentManagementSystem::show_all_students(bool compact) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (students_.empty()) {
+        std::cout << "当前没有学生数据。" << std::endl;
+        return;
+    }
     
-    if (error_count > 0) {
-        logger_.warn("从文件加载数据完成，成功加载 " + std::to_string(count) + 
-                     " 个学生，跳过 " + std::to_string(error_count) + " 个无效数据：" + filename);
+    // 先渲染到缓冲区，每积累约64KB写出一次，避免逐字段输出和逐行刷新
+    constexpr size_t FLUSH_BYTES = 64 * 1024;
+    std::string buffer;
+    buffer.reserve(FLUSH_BYTES + 1024);
+    buffer += "=== 学生信息列表 ===\n总数：" + std::to_string(students_.size()) + "\n";
+    if (compact) {
+        Student::format_table_header(buffer);
     } else {
-        logger_.info("从文件加载了 " + std::to_string(count) + " 个学生数据：" + filename);
+        buffer += "-------------------\n";
     }
     
-    return count > 0;
+    for (const auto& student : students_) {
+        if (compact) {
+            student.format_row_into(buffer);
+        } else {
+            student.format_into(buffer);
+            buffer += "-------------------\n";
+        }
+        if (buffer.size() >= FLUSH_BYTES) {
+            std::cout.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    }
+    std::cout.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    std::cout.flush();
 }
 
-bool StudentManagementSystem::save_to_excel_file(const std::string& filename) {
-    std::ofstream file(filename);
-    if (!file.is_open()) {
-        logger_.error("无法打开文件进行保存：" + filename);
-        return false;
+StudentPage StudentManagementSystem::list_students(size_t page_size, StudentSortKey key,
+                                                   const std::string& resume_token) const {
+    if (page_size == 0) {
+        throw std::invalid_argument("每页学生数必须大于0");
+    }
+    
+    // 令牌格式：排序键编号:学号:排序值
+    bool has_cursor = !resume_token.empty();
+    StudentId cursor_id;
+    std::string cursor_text;
+    float cursor_average = 0.0f;
+    if (has_cursor) {
+        size_t first = resume_token.find(':');
+        size_t second = first == std::string::npos ? first : resume_token.find(':', first + 1);
+        if (second == std::string::npos ||
+            resume_token.substr(0, first) != std::to_string(static_cast<int>(key))) {
+            throw std::invalid_argument("续页令牌无效");
+        }
+        if (!StudentId::parse(resume_token.substr(first + 1, second - first - 1), cursor_id)) {
+            throw std::invalid_argument("续页令牌无效");
+        }
+        cursor_text = resume_token.substr(second + 1);
+        if (key == StudentSortKey::AVERAGE_SCORE) {
+            try {
+                cursor_average = std::stof(cursor_text);
+            } catch (const std::exception&) {
+                throw std::invalid_argument("续页令牌无效");
+            }
+        }
     }
     
-    // 按学号排序
-    sort_students_by_id();
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    const PageIndex& pages = page_index(key);
+    PageKey cursor{cursor_text, cursor_average, cursor_id};
+    std::vector<StudentId> ids;
     
-    // 添加Excel表头（包含成绩信息）
-    file << "学号,姓名,性别,班级,电话,邮箱,成绩信息\n";
+    StudentPage page;
+    page.total = students_.size();
+    page.remaining = pages.page_after(has_cursor ? &cursor : nullptr, page_size, ids);
+    page.students.reserve(ids.size());
+    for (const StudentId& id : ids) {
+        page.students.push_back(**id_index_.find(id));
+    }
     
-    // 保存数据（包含成绩信息）
-    for (const auto& student : students_) {
-        file << student.get_id() << ","
-             << student.get_name() << ","
-             << student.get_gender() << ","
-             << student.get_class_id() << ","
-             << student.get_phone() << ","
-             << student.get_email() << ",";
-        
-        // 保存成绩信息
-        const auto& scores = student.get_scores();
-        if (!scores.empty()) {
-            bool first = true;
-            for (const auto& [subject, score] : scores) {
-                if (!first) file << ";";
-                file << subject << ":" << score;
-                first = false;
-            }
+    if (page.remaining > 0) {
+        PageKey last = pages.key_of(page.students.back());
+        std::ostringstream token;
+        token << static_cast<int>(key) << ':' << page.students.back().get_id() << ':';
+        if (key == StudentSortKey::AVERAGE_SCORE) {
+            token << std::setprecision(9) << last.average;
         } else {
-            file << "无成绩";
+            token << last.text;
         }
-        file << "\n";
+        page.next_token = token.str();
     }
-    
-    file.close();
-    logger_.info("成功保存Excel格式数据到文件：" + filename);
-    return true;
+    return page;
 }
 
-void StudentManagementSystem::show_all_students() const {
-    if (students_.empty()) {
-        std::cout << "当前没有学生数据。" << std::endl;
-        return;
+std::string StudentManagementSystem::render_page(const StudentPage& page, size_t first_index, bool compact) {
+    std::string buffer;
+    if (page.students.empty()) {
+        buffer += "当前没有学生数据。\n";
+        return buffer;
     }
     
-    std::cout << "=== 学生信息列表 ===" << std::endl;
-    std::cout << "总数：" << students_.size() << std::endl;
-    std::cout << "-------------------" << std::endl;
-    
-    for (const auto& student : students_) {
-        student.show_info();
-        std::cout << "-------------------" << std::endl;
+    size_t last_index = first_index + page.students.size() - 1;
+    buffer += "=== 学生信息列表（第 " + std::to_string(first_index) + "-" + std::to_string(last_index) +
+              " 名，共 " + std::to_string(page.total) + " 名）===\n";
+    if (compact) {
+        Student::format_table_header(buffer);
+        for (const auto& student : page.students) {
+            student.format_row_into(buffer);
+        }
+    } else {
+        buffer += "-------------------\n";
+        for (const auto& student : page.students) {
+            student.format_into(buffer);
+            buffer += "-------------------\n";
+        }
     }
+    return buffer;
 }
 
 bool StudentManagementSystem::delete_student_by_name(const std::string& name) {
-    auto matching_students = find_students_by_name_exact(name);
+    std::vector<std::string> matching_ids;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        for (const auto& student : students_) {
+            if (student.get_name() == name) {  // 精确匹配
+                matching_ids.push_back(student.get_id());
+            }
+        }
+        
+        if (matching_ids.size() > 1) {
+            // 重名情况，显示所有匹配学生
+            std::cout << "发现 " << matching_ids.size() << " 个同名学生：" << std::endl;
+            
+            std::string buffer;
+            int index = 1;
+            for (const auto& id : matching_ids) {
+                buffer += "[" + std::to_string(index++) + "] ";
+                find_iter(id)->format_into(buffer);
+                buffer += "-------------------\n";
+            }
+            std::cout << buffer << std::flush;
+        }
+    }
     
-    if (matching_students.empty()) {
+    if (matching_ids.empty()) {
         logger_.warn("删除学生失败：姓名 " + name + " 不存在");
         return false;
     }
     
-    if (matching_students.size() == 1) {
-        // 只有一个匹配，直接删除
-        students_.remove_if([&matching_students](const Student& s) {
-            return s.get_id() == matching_students.front()->get_id();
-        });
-        logger_.info("成功删除学生：" + name);
-        return true;
-    } else {
-        // 重名情况，显示所有匹配学生
-        std::cout << "发现 " << matching_students.size() << " 个同名学生：" << std::endl;
-        
-        // 使用迭代器来遍历列表，而不是使用[]
-        int index = 1;
-        for (auto it = matching_students.begin(); it != matching_students.end(); ++it, ++index) {
-            std::cout << "[" << index << "] ";
-            (*it)->show_info();
-            std::cout << "-------------------" << std::endl;
-        }
-        
+    // 只有一个匹配时直接删除；重名时等待用户选择（等待输入期间不持有锁）
+    size_t choice = 1;
+    if (matching_ids.size() > 1) {
         std::cout << "请输入要删除的学生编号: ";
-        int choice;
-        std::cin >> choice;
+        int input;
+        std::cin >> input;
         std::cin.ignore();
         
-        if (choice < 1 || choice > static_cast<int>(matching_students.size())) {
+        if (input < 1 || input > static_cast<int>(matching_ids.size())) {
             logger_.warn("删除学生失败：无效的选择");
             return false;
         }
-        
-        // 使用迭代器找到对应位置的学生
-        auto it = matching_students.begin();
-        std::advance(it, choice - 1); // 移动到选择的位置
-        
-        students_.remove_if([it](const Student& s) {
-            return s.get_id() == (*it)->get_id();
-        });
+        choice = static_cast<size_t>(input);
+    }
+    
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (!check_writable("删除学生")) return false;
+    auto it = find_iter(matching_ids[choice - 1]);
+    if (it == students_.end() || it->get_name() != name) {
+        logger_.warn("删除学生失败：学生 " + matching_ids[choice - 1] + " 已被修改或删除");
+        return false;
+    }
+    
+    erase_record(it);
+    if (matching_ids.size() > 1) {
         logger_.info("成功删除学生：" + name + " (编号" + std::to_string(choice) + ")");
-        return true;
+    } else {
+        logger_.info("成功删除学生：" + name);
     }
+    return true;
 }
 
-std::list<Student*> StudentManagementSystem::find_students_by_name_exact(const std::string& name) {
-    std::list<Student*> result;
+std::vector<Student> StudentManagementSystem::find_students_by_name_exact(const std::string& name) {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    std::vector<Student> result;
     
-    for (auto& student : students_) {
+    for (const auto& student : students_) {
         if (student.get_name() == name) {  // 精确匹配
-            result.push_back(&student);
+            result.push_back(student);
         }
     }
     
@@ -356,17 +1733,116 @@ std::list<Student*> StudentManagementSystem::find_students_by_name_exact(const s
 }
 
 void StudentManagementSystem::sort_students_by_id() {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    sort_records_by_id();
+}
+
+std::vector<Student> StudentManagementSystem::sort_by(const std::vector<SortKey>& keys) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    std::vector<Student> result;
+    result.reserve(students_.size());
+    for (const Student* student : sorted_records(keys)) result.push_back(*student);
+    return result;
+}
+
+std::vector<const Student*> StudentManagementSystem::sorted_records(const std::vector<SortKey>& keys) const {
+    std::vector<const Student*> items;
+    items.reserve(students_.size());
+    for (const auto& student : students_) items.push_back(&student);
+    
+    // 先把每个排序键的值取到连续数组中，排序时只比较数组元素
+    std::vector<SortColumn> columns;
+    for (const auto& key : keys.empty() ? std::vector<SortKey>(1) : keys) {
+        SortColumn column{key.field, key.descending, {}, {}, {}};
+        for (const Student* student : items) {
+            switch (key.field) {
+                case SortField::ID:
+                    column.ids.push_back(student->get_id_key());
+                    break;
+                case SortField::NAME:
+                    column.texts.push_back(&student->get_name());
+                    break;
+                case SortField::CLASS_ID:
+                    column.texts.push_back(&student->get_class_id());
+                    break;
+                case SortField::AVERAGE_SCORE:
+                    column.numbers.push_back(student->get_score_count() > 0 ? student->get_average_score() : -1.0f);
+                    break;
+                case SortField::SUBJECT_SCORE:
+                    column.numbers.push_back(student->get_score(key.subject));
+                    break;
+            }
+        }
+        columns.push_back(std::move(column));
+    }
+    
+    std::vector<uint32_t> order(items.size());
+    for (uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+    parallel_stable_sort(order, [&columns](uint32_t a, uint32_t b) {
+        for (const auto& column : columns) {
+            int result = compare_column(column, a, b);
+            if (result != 0) return result < 0;
+        }
+        return false;
+    });
+    
+    std::vector<const Student*> result(items.size());
+    for (size_t i = 0; i < order.size(); ++i) result[i] = items[order[i]];
+    return result;
+}
+
+bool StudentManagementSystem::parse_sort_keys(const std::string& spec, std::vector<SortKey>& keys) {
+    static const std::string DESCENDING = "降序";
+    static const std::string ASCENDING = "升序";
+    keys.clear();
+    
+    std::istringstream iss(spec);
+    std::string item;
+    while (std::getline(iss, item, ',')) {
+        item.erase(0, item.find_first_not_of(' '));
+        item.erase(item.find_last_not_of(' ') + 1);
+        
+        SortKey key;
+        auto ends_with = [&item](const std::string& suffix) {
+            return item.size() > suffix.size() && item.compare(item.size() - suffix.size(), suffix.size(), suffix) == 0;
+        };
+        if (ends_with(DESCENDING)) {
+            key.descending = true;
+            item.resize(item.size() - DESCENDING.size());
+        } else if (ends_with(ASCENDING)) {
+            item.resize(item.size() - ASCENDING.size());
+        }
+        if (item.empty()) return false;
+        
+        if (item == "学号") {
+            key.field = SortField::ID;
+        } else if (item == "姓名") {
+            key.field = SortField::NAME;
+        } else if (item == "班级") {
+            key.field = SortField::CLASS_ID;
+        } else if (item == "平均分") {
+            key.field = SortField::AVERAGE_SCORE;
+        } else {
+            key.field = SortField::SUBJECT_SCORE;
+            key.subject = item;
+        }
+        keys.push_back(std::move(key));
+    }
+    return !keys.empty() || spec.find_first_not_of(' ') == std::string::npos;
+}
+
+void StudentManagementSystem::sort_records_by_id() {
+    // list::sort只重新链接节点，索引中的迭代器保持有效
     students_.sort([](const Student& a, const Student& b) {
-        return a.get_id() < b.get_id();
+        return a.get_id_key() < b.get_id_key();
     });
     logger_.info("按学号排序完成");
 }
 
 bool StudentManagementSystem::set_student_score(const std::string& student_id, const std::string& subject, float score) {
-    auto it = std::find_if(students_.begin(), students_.end(),
-        [&student_id](const Student& student) {
-            return student.get_id() == student_id;
-        });
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (!check_writable("设置成绩")) return false;
+    auto it = find_iter(student_id);
     
     if (it == students_.end()) {
         logger_.warn("设置成绩失败：学号 " + student_id + " 不存在");
@@ -374,7 +1850,7 @@ bool StudentManagementSystem::set_student_score(const std::string& student_id, c
     }
     
     try {
-        it->set_score(subject, score);
+        set_record_score(it, subject, score);
         logger_.info("成功设置学生成绩：" + student_id + " - " + subject + " = " + std::to_string(score));
         return true;
     } catch (const std::invalid_argument& e) {
@@ -384,10 +1860,8 @@ bool StudentManagementSystem::set_student_score(const std::string& student_id, c
 }
 
 std::string StudentManagementSystem::get_student_scores_info(const std::string& student_id) {
-    auto it = std::find_if(students_.begin(), students_.end(),
-        [&student_id](const Student& student) {
-            return student.get_id() == student_id;
-        });
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = find_iter(student_id);
     
     if (it == students_.end()) {
         return "学生不存在";
@@ -401,12 +1875,152 @@ std::string StudentManagementSystem::get_student_scores_info(const std::string&
     if (scores.empty()) {
         ss << "该学生暂无成绩记录";
     } else {
+        auto append_rank = [this, &ss, &it](const std::string& subject, float score) {
+            ScoreRank in_class = score_ranks_.class_rank(it->get_class_id(), subject, score);
+            ScoreRank in_school = score_ranks_.school_rank(subject, score);
+            ss << "（班级第" << in_class.rank << "/" << in_class.total
+               << "名，全校第" << in_school.rank << "/" << in_school.total << "名）";
+        };
         ss << "成绩列表:\n";
         for (const auto& [subject, score] : scores) {
-            ss << "  " << subject << ": " << score << "\n";
+            ss << "  " << subject << ": " << score;
+            append_rank(subject, score);
+            ss << "\n";
         }
         ss << "平均分: " << it->get_average_score();
+        append_rank(std::string(), it->get_average_score());
     }
     
     return ss.str();
+}
+
+bool StudentManagementSystem::rank_of(const std::string& student_id, const std::string& subject,
+                                      ScoreRank& class_rank, ScoreRank& school_rank) {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = find_iter(student_id);
+    if (it == students_.end()) return false;
+    
+    float score = subject.empty() ? it->get_average_score() : it->get_score(subject);
+    if (it->get_score_count() == 0 || score < 0) return false;
+    
+    class_rank = score_ranks_.class_rank(it->get_class_id(), subject, score);
+    school_rank = score_ranks_.school_rank(subject, score);
+    return true;
+}
+
+std::vector<std::string> StudentManagementSystem::complete_student_id(const std::string& prefix, size_t limit) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return id_prefix_.complete(prefix, limit);
+}
+
+std::vector<std::string> StudentManagementSystem::complete_student_name(const std::string& prefix, size_t limit) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return name_prefix_.complete(prefix, limit);
+}
+
+std::vector<std::string> StudentManagementSystem::suggest_student_ids(const std::string& input, size_t limit) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return id_prefix_.suggest(input, limit);
+}
+
+std::vector<std::string> StudentManagementSystem::suggest_student_names(const std::string& input, size_t limit) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return name_prefix_.suggest(input, limit);
+}
+
+std::vector<NameMatch> StudentManagementSystem::search_students_by_name(const std::string& query, size_t limit,
+                                                                        int max_distance) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    std::vector<NameMatch> result;
+    
+    // 姓名结果已按距离、姓名排序，同名学生按学号排序
+    for (const auto& match : name_search_.search(query, max_distance)) {
+        auto ids = name_ids_.find(match.name);
+        if (ids == name_ids_.end()) continue;
+        
+        for (const auto& id : ids->second) {
+            if (result.size() >= limit) return result;
+            result.push_back({id.to_string(), match.name, match.distance});
+        }
+    }
+    return result;
+}
+
+bool StudentManagementSystem::load_pinyin_table(const std::string& filename) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    size_t loaded = name_search_.load_pinyin_table(filename);
+    if (loaded == 0) {
+        logger_.error("拼音表加载失败或为空: " + filename);
+        return false;
+    }
+    logger_.info("成功加载拼音表条目 " + std::to_string(loaded) + " 个");
+    return true;
+}
+
+bool StudentManagementSystem::check_writable(const std::string& operation) {
+    if (!frozen_) return true;
+    logger_.warn(operation + "失败：名册已冻结（只读）");
+    return false;
+}
+
+bool StudentManagementSystem::check_all_columns(const std::string& operation) {
+    if (loaded_columns_.is_all()) return true;
+    logger_.warn(operation + "失败：名册只加载了部分列（" + loaded_columns_.to_string() + "），请先加载全部列");
+    return false;
+}
+
+bool StudentManagementSystem::check_load_columns(const ColumnSet& columns) {
+    if (columns.is_all()) return true;
+    if (log_store_.is_open()) {
+        logger_.warn("加载数据失败：日志结构存储已打开，不能只加载部分列");
+        return false;
+    }
+    // 加载的学生以ADD事件写入变更日志，缺少必填字段的记录副本无法解码，会悄悄跳过
+    if (changes_.is_log_open()) {
+        logger_.warn("加载数据失败：变更日志已打开，不能只加载部分列");
+        return false;
+    }
+    return true;
+}
+
+ColumnSet StudentManagementSystem::loaded_columns() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return loaded_columns_;
+}
+
+bool StudentManagementSystem::freeze(const std::string& filename) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (!check_all_columns("冻结名册")) return false;
+    if (!FrozenRoster::write(students_, filename)) {
+        logger_.error("冻结名册失败：无法写入文件 " + filename);
+        return false;
+    }
+    
+    auto roster = std::make_unique<FrozenRoster>();
+    if (!roster->open(filename)) {
+        logger_.error("冻结名册失败：无法映射文件 " + filename);
+        return false;
+    }
+    
+    // 槽位->链表迭代器，使按学号查询仍读取内存中的学生对象
+    frozen_slots_.assign(roster->size(), students_.end());
+    for (auto it = students_.begin(); it != students_.end(); ++it) {
+        frozen_slots_[static_cast<size_t>(roster->find_slot(it->get_id_key()))] = it;
+    }
+    frozen_ = std::move(roster);
+    logger_.info("名册已冻结：" + std::to_string(students_.size()) + " 名学生，文件 " + filename);
+    return true;
+}
+
+void StudentManagementSystem::unfreeze() {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (!frozen_) return;
+    frozen_.reset();
+    frozen_slots_.clear();
+    logger_.info("名册已解冻");
+}
+
+bool StudentManagementSystem::is_frozen() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return frozen_ != nullptr;
 }
\ No newline at end of file
@@ -0,0 +1,57 @@
+#include "transaction.hh"
+
+Transaction::Transaction(Transaction&& other) noexcept
+    : ops_(std::move(other.ops_)), active_(other.active_) {
+    other.ops_.clear();
+    other.active_ = false;
+}
+
+Transaction& Transaction::operator=(Transaction&& other) noexcept {
+    if (this != &other) {
+        ops_ = std::move(other.ops_);
+        active_ = other.active_;
+        other.ops_.clear();
+        other.active_ = false;
+    }
+    return *this;
+}
+
+void Transaction::add_student(const Student& student) {
+    TransactionOp op;
+    op.type = TransactionOpType::ADD;
+    op.student_id = student.get_id();
+    op.student = student;
+    ops_.push_back(std::move(op));
+}
+
+void Transaction::update_student(const std::string& student_id, const Student& new_student) {
+    TransactionOp op;
+    op.type = TransactionOpType::UPDATE;
+    op.student_id = student_id;
+    op.student = new_student;
+    ops_.push_back(std::move(op));
+}
+
+void Transaction::delete_student(const std::string& student_id) {
+    TransactionOp op;
+    op.type = TransactionOpType::DELETE;
+    op.student_id = student_id;
+    ops_.push_back(std::move(op));
+}
+
+void Transaction::set_score(const std::string& student_id, const std::string& subject, float score) {
+    TransactionOp op;
+    op.type = TransactionOpType::SET_SCORE;
+    op.student_id = student_id;
+    op.value = subject;
+    op.score = score;
+    ops_.push_back(std::move(op));
+}
+
+void Transaction::set_class_id(const std::string& student_id, const std::string& class_id) {
+    TransactionOp op;
+    op.type = TransactionOpType::SET_CLASS;
+    op.student_id = student_id;
+    op.value = class_id;
+    ops_.push_back(std::move(op));
+}
@@ -0,0 +1,110 @@
+#include "undo_history.hh"
+#include <algorithm>
+
+UndoHistory::UndoHistory(size_t capacity) : undo_(capacity), redo_(capacity) {}
+
+void UndoHistory::begin_group() {
+    if (group_depth_++ == 0) {
+        current_group_ = next_group_++;
+    }
+}
+
+void UndoHistory::end_group() {
+    if (group_depth_ > 0 && --group_depth_ == 0) {
+        current_group_ = 0;
+    }
+}
+
+void UndoHistory::record(UndoRecord record) {
+    redo_.clear();
+    record.group = group_depth_ > 0 ? current_group_ : next_group_++;
+    if (record.group == dropped_group_) return;
+    
+    if (!push_bounded(undo_, std::move(record))) {
+        // 当前批次本身超过容量，无法整体撤销
+        undo_.clear();
+        dropped_group_ = current_group_;
+    }
+}
+
+bool UndoHistory::push_bounded(RingBuffer<UndoRecord>& ring, UndoRecord record) {
+    if (ring.size() == ring.capacity()) {
+        uint64_t evicted = ring.at(0).group;
+        if (evicted == record.group) return false;
+        while (!ring.empty() && ring.at(0).group == evicted) {
+            ring.pop_front();
+        }
+    }
+    ring.push_back(std::move(record));
+    return true;
+}
+
+bool UndoHistory::pop_undo(std::vector<UndoRecord>& out) {
+    out.clear();
+    if (undo_.empty()) return false;
+    
+    uint64_t group = undo_.back().group;
+    while (!undo_.empty() && undo_.back().group == group) {
+        out.push_back(undo_.pop_back());
+    }
+    return true;
+}
+
+bool UndoHistory::pop_redo(std::vector<UndoRecord>& out) {
+    out.clear();
+    if (redo_.empty()) return false;
+    
+    uint64_t group = redo_.back().group;
+    while (!redo_.empty() && redo_.back().group == group) {
+        out.push_back(redo_.pop_back());
+    }
+    return true;
+}
+
+void UndoHistory::push_redo(std::vector<UndoRecord>& records) {
+    // 撤销顺序为从新到旧，重做栈顶应为该批次最旧的记录
+    for (auto& record : records) {
+        push_bounded(redo_, std::move(record));
+    }
+    records.clear();
+}
+
+void UndoHistory::push_undo(std::vector<UndoRecord>& records) {
+    for (auto& record : records) {
+        push_bounded(undo_, std::move(record));
+    }
+    records.clear();
+}
+
+void UndoHistory::clear() {
+    undo_.clear();
+    redo_.clear();
+}
+
+UndoRecord UndoHistory::make_update(const Student& before, const Student& after) {
+    UndoRecord record;
+    record.kind = UndoKind::UPDATE;
+    record.student_id = after.get_id();
+    
+    student_schema::StudentFields::for_each([&](auto descriptor) {
+        using Field = decltype(descriptor);
+        if (Field::get(before) != Field::get(after)) {
+            record.fields.push_back({Field::KEY, Field::get(before), Field::get(after)});
+        }
+    });
+    
+    // 成绩差异：修改和删除的科目
+    for (const auto& [subject, score] : before.get_scores()) {
+        float new_score = after.get_score(subject);
+        if (new_score != score) {
+            record.scores.push_back({subject, score, new_score});
+        }
+    }
+    // 新增的科目
+    for (const auto& [subject, score] : after.get_scores()) {
+        if (before.get_score(subject) < 0) {
+            record.scores.push_back({subject, -1.0f, score});
+        }
+    }
+    return record;
+}